@@ -16,11 +16,36 @@
 #include <new>
 #include <fstream>
 #include <filesystem>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// Hardware float to half conversion, if the compiler targets it
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define DDS_LOADER_F16C
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define DDS_LOADER_NEON_FP16
+#endif
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #include <debugapi.h>
 #else
 #include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 #endif
 
 #ifdef __clang__
@@ -197,11 +222,6 @@ namespace
 
         *bitSize = 0;
 
-        if (ddsDataSize > UINT32_MAX)
-        {
-            return DDS_LOADER_FAIL;
-        }
-
         if (ddsDataSize < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
         {
             return DDS_LOADER_FAIL;
@@ -249,9 +269,62 @@ namespace
     }
 
 
+    //--------------------------------------------------------------------------------------
+    // Reads size bytes from the current file position in chunks, some C runtimes fail single reads of 2 GiB or more
+    //--------------------------------------------------------------------------------------
+    bool ReadFileData(std::ifstream& inFile, uint8_t* dst, uint64_t size)
+    {
+        constexpr uint64_t maxChunkSize = uint64_t(1) << 30;
+        while (size > 0)
+        {
+            const uint64_t chunkSize = std::min(size, maxChunkSize);
+            inFile.read(reinterpret_cast<char*>(dst), std::streamsize(chunkSize));
+            if (!inFile)
+            {
+                return false;
+            }
+
+            dst  += chunkSize;
+            size -= chunkSize;
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // The DDS data of the file loaders lives at fileOffset inside the file, ddsDataSize of UINT64_MAX
+    // means the data reaches the end of the file. Returns the size of the data in dataSize.
+    //--------------------------------------------------------------------------------------
+    constexpr uint64_t WholeFileDataSize = UINT64_MAX;
+
+    DDS_LOADER_RESULT GetFileDataSize(uint64_t fileLen, uint64_t fileOffset, uint64_t ddsDataSize, uint64_t& dataSize) noexcept
+    {
+        if (fileOffset > fileLen)
+        {
+            return DDS_LOADER_FAIL;
+        }
+
+        if (ddsDataSize == WholeFileDataSize)
+        {
+            dataSize = fileLen - fileOffset;
+        }
+        else if (ddsDataSize <= fileLen - fileOffset)
+        {
+            dataSize = ddsDataSize;
+        }
+        else
+        {
+            return DDS_LOADER_UNEXPECTED_EOF;
+        }
+
+        return DDS_LOADER_SUCCESS;
+    }
+
     //--------------------------------------------------------------------------------------
     DDS_LOADER_RESULT LoadTextureDataFromFile(
         const char_type* fileName,
+        uint64_t fileOffset,
+        uint64_t ddsDataSize,
         std::unique_ptr<uint8_t[]>& ddsData,
         const DDS_HEADER** header,
         const uint8_t** bitData,
@@ -272,23 +345,31 @@ namespace
         if (!inFile)
             return DDS_LOADER_FAIL;
 
+        uint64_t dataLen = 0;
+        DDS_LOADER_RESULT errCode = GetFileDataSize(uint64_t(fileLen), fileOffset, ddsDataSize, dataLen);
+        if (errCode != DDS_LOADER_SUCCESS)
+            return errCode;
+
         // Need at least enough data to fill the header and magic number to be a valid DDS
-        if (fileLen < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
+        if (dataLen < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
             return DDS_LOADER_FAIL;
 
-        ddsData.reset(new (std::nothrow) uint8_t[size_t(fileLen)]);
+        // Files larger than the address space can only be loaded by parts
+        if (dataLen > SIZE_MAX)
+            return DDS_LOADER_ARITHMETIC_OVERFLOW;
+
+        ddsData.reset(new (std::nothrow) uint8_t[size_t(dataLen)]);
         if (!ddsData)
             return DDS_LOADER_FAIL;
 
-        inFile.seekg(0, std::ios::beg);
+        inFile.seekg(std::streamoff(fileOffset), std::ios::beg);
         if (!inFile)
         {
             ddsData.reset();
             return DDS_LOADER_FAIL;
         }
 
-       inFile.read(reinterpret_cast<char*>(ddsData.get()), fileLen);
-       if (!inFile)
+       if (!ReadFileData(inFile, ddsData.get(), dataLen))
        {
            ddsData.reset();
            return DDS_LOADER_FAIL;
@@ -296,7 +377,7 @@ namespace
 
        inFile.close();
 
-       size_t len = fileLen;
+       size_t len = size_t(dataLen);
 
         // DDS files always start with the same magic number ("DDS ")
         auto dwMagicNumber = *reinterpret_cast<const uint32_t*>(ddsData.get());
@@ -341,6 +422,59 @@ namespace
         return DDS_LOADER_SUCCESS;
     }
 
+    //--------------------------------------------------------------------------------------
+    // Reads only the headers of the DDS data in the file, for the callers that read the subresources by themselves.
+    // headerData must be MaxDDSHeaderSize bytes long and 4-byte aligned. bitDataOffset is the file offset of the subresource data.
+    //--------------------------------------------------------------------------------------
+    constexpr size_t MaxDDSHeaderSize = sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10);
+
+    DDS_LOADER_RESULT LoadTextureHeaderFromFile(
+        const char_type* fileName,
+        uint64_t fileOffset,
+        uint64_t ddsDataSize,
+        uint8_t* headerData,
+        const DDS_HEADER** header,
+        uint64_t* bitDataOffset,
+        uint64_t* bitSize) noexcept
+    {
+        if (!headerData || !header || !bitDataOffset || !bitSize)
+        {
+            return DDS_LOADER_BAD_POINTER;
+        }
+
+        std::ifstream inFile(std::filesystem::path(fileName), std::ios::in | std::ios::binary | std::ios::ate);
+        if (!inFile)
+            return DDS_LOADER_FAIL;
+
+        std::streampos fileLen = inFile.tellg();
+        if (!inFile)
+            return DDS_LOADER_FAIL;
+
+        uint64_t dataLen = 0;
+        DDS_LOADER_RESULT errCode = GetFileDataSize(uint64_t(fileLen), fileOffset, ddsDataSize, dataLen);
+        if (errCode != DDS_LOADER_SUCCESS)
+            return errCode;
+
+        const size_t headerSize = size_t(std::min<uint64_t>(dataLen, MaxDDSHeaderSize));
+
+        inFile.seekg(std::streamoff(fileOffset), std::ios::beg);
+        inFile.read(reinterpret_cast<char*>(headerData), headerSize);
+        if (!inFile)
+            return DDS_LOADER_FAIL;
+
+        const uint8_t* bitData = nullptr;
+        size_t headerBitSize = 0;
+        errCode = LoadTextureDataFromMemory(headerData, headerSize, header, &bitData, &headerBitSize);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        *bitDataOffset = fileOffset + uint64_t(bitData - headerData);
+        *bitSize       = dataLen - uint64_t(bitData - headerData);
+        return DDS_LOADER_SUCCESS;
+    }
+
     //--------------------------------------------------------------------------------------
     // Returns true if dxgiFormat belongs to _TYPELESS family of formats.
     // Otherwise, returns false.
@@ -371,7 +505,21 @@ namespace
             || dxgiFormat == 90  //DXGI_FORMAT_B8G8R8A8_TYPELESS
             || dxgiFormat == 92  //DXGI_FORMAT_B8G8R8X8_TYPELESS
             || dxgiFormat == 94  //DXGI_FORMAT_BC6H_TYPELESS
-            || dxgiFormat == 97; //DXGI_FORMAT_BC7_TYPELESS
+            || dxgiFormat == 97  //DXGI_FORMAT_BC7_TYPELESS
+            || dxgiFormat == 133  //DXGI_FORMAT_ASTC_4X4_TYPELESS
+            || dxgiFormat == 137  //DXGI_FORMAT_ASTC_5X4_TYPELESS
+            || dxgiFormat == 141  //DXGI_FORMAT_ASTC_5X5_TYPELESS
+            || dxgiFormat == 145  //DXGI_FORMAT_ASTC_6X5_TYPELESS
+            || dxgiFormat == 149  //DXGI_FORMAT_ASTC_6X6_TYPELESS
+            || dxgiFormat == 153  //DXGI_FORMAT_ASTC_8X5_TYPELESS
+            || dxgiFormat == 157  //DXGI_FORMAT_ASTC_8X6_TYPELESS
+            || dxgiFormat == 161  //DXGI_FORMAT_ASTC_8X8_TYPELESS
+            || dxgiFormat == 165  //DXGI_FORMAT_ASTC_10X5_TYPELESS
+            || dxgiFormat == 169  //DXGI_FORMAT_ASTC_10X6_TYPELESS
+            || dxgiFormat == 173  //DXGI_FORMAT_ASTC_10X8_TYPELESS
+            || dxgiFormat == 177  //DXGI_FORMAT_ASTC_10X10_TYPELESS
+            || dxgiFormat == 181  //DXGI_FORMAT_ASTC_12X10_TYPELESS
+            || dxgiFormat == 185; //DXGI_FORMAT_ASTC_12X12_TYPELESS
     }
 
     //--------------------------------------------------------------------------------------
@@ -843,6 +991,104 @@ namespace
             return VK_FORMAT_R8G8B8A8_UNORM;
 #endif
 
+        case 133: //DXGI_FORMAT_ASTC_4X4_TYPELESS
+        case 134: //DXGI_FORMAT_ASTC_4X4_UNORM
+            return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+
+        case 135: //DXGI_FORMAT_ASTC_4X4_UNORM_SRGB
+            return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
+
+        case 137: //DXGI_FORMAT_ASTC_5X4_TYPELESS
+        case 138: //DXGI_FORMAT_ASTC_5X4_UNORM
+            return VK_FORMAT_ASTC_5x4_UNORM_BLOCK;
+
+        case 139: //DXGI_FORMAT_ASTC_5X4_UNORM_SRGB
+            return VK_FORMAT_ASTC_5x4_SRGB_BLOCK;
+
+        case 141: //DXGI_FORMAT_ASTC_5X5_TYPELESS
+        case 142: //DXGI_FORMAT_ASTC_5X5_UNORM
+            return VK_FORMAT_ASTC_5x5_UNORM_BLOCK;
+
+        case 143: //DXGI_FORMAT_ASTC_5X5_UNORM_SRGB
+            return VK_FORMAT_ASTC_5x5_SRGB_BLOCK;
+
+        case 145: //DXGI_FORMAT_ASTC_6X5_TYPELESS
+        case 146: //DXGI_FORMAT_ASTC_6X5_UNORM
+            return VK_FORMAT_ASTC_6x5_UNORM_BLOCK;
+
+        case 147: //DXGI_FORMAT_ASTC_6X5_UNORM_SRGB
+            return VK_FORMAT_ASTC_6x5_SRGB_BLOCK;
+
+        case 149: //DXGI_FORMAT_ASTC_6X6_TYPELESS
+        case 150: //DXGI_FORMAT_ASTC_6X6_UNORM
+            return VK_FORMAT_ASTC_6x6_UNORM_BLOCK;
+
+        case 151: //DXGI_FORMAT_ASTC_6X6_UNORM_SRGB
+            return VK_FORMAT_ASTC_6x6_SRGB_BLOCK;
+
+        case 153: //DXGI_FORMAT_ASTC_8X5_TYPELESS
+        case 154: //DXGI_FORMAT_ASTC_8X5_UNORM
+            return VK_FORMAT_ASTC_8x5_UNORM_BLOCK;
+
+        case 155: //DXGI_FORMAT_ASTC_8X5_UNORM_SRGB
+            return VK_FORMAT_ASTC_8x5_SRGB_BLOCK;
+
+        case 157: //DXGI_FORMAT_ASTC_8X6_TYPELESS
+        case 158: //DXGI_FORMAT_ASTC_8X6_UNORM
+            return VK_FORMAT_ASTC_8x6_UNORM_BLOCK;
+
+        case 159: //DXGI_FORMAT_ASTC_8X6_UNORM_SRGB
+            return VK_FORMAT_ASTC_8x6_SRGB_BLOCK;
+
+        case 161: //DXGI_FORMAT_ASTC_8X8_TYPELESS
+        case 162: //DXGI_FORMAT_ASTC_8X8_UNORM
+            return VK_FORMAT_ASTC_8x8_UNORM_BLOCK;
+
+        case 163: //DXGI_FORMAT_ASTC_8X8_UNORM_SRGB
+            return VK_FORMAT_ASTC_8x8_SRGB_BLOCK;
+
+        case 165: //DXGI_FORMAT_ASTC_10X5_TYPELESS
+        case 166: //DXGI_FORMAT_ASTC_10X5_UNORM
+            return VK_FORMAT_ASTC_10x5_UNORM_BLOCK;
+
+        case 167: //DXGI_FORMAT_ASTC_10X5_UNORM_SRGB
+            return VK_FORMAT_ASTC_10x5_SRGB_BLOCK;
+
+        case 169: //DXGI_FORMAT_ASTC_10X6_TYPELESS
+        case 170: //DXGI_FORMAT_ASTC_10X6_UNORM
+            return VK_FORMAT_ASTC_10x6_UNORM_BLOCK;
+
+        case 171: //DXGI_FORMAT_ASTC_10X6_UNORM_SRGB
+            return VK_FORMAT_ASTC_10x6_SRGB_BLOCK;
+
+        case 173: //DXGI_FORMAT_ASTC_10X8_TYPELESS
+        case 174: //DXGI_FORMAT_ASTC_10X8_UNORM
+            return VK_FORMAT_ASTC_10x8_UNORM_BLOCK;
+
+        case 175: //DXGI_FORMAT_ASTC_10X8_UNORM_SRGB
+            return VK_FORMAT_ASTC_10x8_SRGB_BLOCK;
+
+        case 177: //DXGI_FORMAT_ASTC_10X10_TYPELESS
+        case 178: //DXGI_FORMAT_ASTC_10X10_UNORM
+            return VK_FORMAT_ASTC_10x10_UNORM_BLOCK;
+
+        case 179: //DXGI_FORMAT_ASTC_10X10_UNORM_SRGB
+            return VK_FORMAT_ASTC_10x10_SRGB_BLOCK;
+
+        case 181: //DXGI_FORMAT_ASTC_12X10_TYPELESS
+        case 182: //DXGI_FORMAT_ASTC_12X10_UNORM
+            return VK_FORMAT_ASTC_12x10_UNORM_BLOCK;
+
+        case 183: //DXGI_FORMAT_ASTC_12X10_UNORM_SRGB
+            return VK_FORMAT_ASTC_12x10_SRGB_BLOCK;
+
+        case 185: //DXGI_FORMAT_ASTC_12X12_TYPELESS
+        case 186: //DXGI_FORMAT_ASTC_12X12_UNORM
+            return VK_FORMAT_ASTC_12x12_UNORM_BLOCK;
+
+        case 187: //DXGI_FORMAT_ASTC_12X12_UNORM_SRGB
+            return VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+
         default:
             //Unknown format.
             return VK_FORMAT_UNDEFINED;
@@ -2396,6 +2642,24 @@ namespace
 
             // BC6H and BC7 are written using the "DX10" extended header
 
+            // ETC formats as written by Compressonator. ETC1 is a subset of ETC2 RGB
+            if (MAKEFOURCC( 'E', 'T', 'C', ' ' ) == ddpf.fourCC)
+            {
+                return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            }
+            if (MAKEFOURCC( 'E', 'T', 'C', '2' ) == ddpf.fourCC)
+            {
+                return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            }
+            if (MAKEFOURCC( 'E', 'T', 'C', 'A' ) == ddpf.fourCC)
+            {
+                return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+            }
+            if (MAKEFOURCC( 'E', 'T', 'C', 'P' ) == ddpf.fourCC)
+            {
+                return VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK;
+            }
+
             if (MAKEFOURCC( 'R', 'G', 'B', 'G' ) == ddpf.fourCC)
             {
                 return VK_FORMAT_G8B8G8R8_422_UNORM;
@@ -2596,851 +2860,7850 @@ namespace
     }
 
     //--------------------------------------------------------------------------------------
-    DDS_LOADER_RESULT FillInitData(size_t width,
-        size_t height,
-        size_t depth,
-        size_t mipCount,
-        size_t arraySize,
-        size_t numberOfPlanes,
-        VkFormat format,
-        size_t maxsize,
-        size_t bitSize,
-        const uint8_t* bitData,
-        size_t& twidth,
-        size_t& theight,
-        size_t& tdepth,
-        size_t& skipMip,
-        std::vector<LoadedSubresourceData>& initData)
+    VkImageAspectFlags GetPlaneAspect(VkFormat format, size_t numberOfPlanes, size_t plane) noexcept
     {
-        if (!bitData)
+        VkImageAspectFlags aspectPlane = VK_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM;
+        if(numberOfPlanes == 1 && !IsDepthStencil(format))
         {
-            return DDS_LOADER_BAD_POINTER;
+            aspectPlane = VK_IMAGE_ASPECT_COLOR_BIT;
+        }
+        else if(numberOfPlanes == 1)
+        {
+            //No separate depth/stencil
+            aspectPlane = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        else if(plane == 0)
+        {
+            aspectPlane = VK_IMAGE_ASPECT_PLANE_0_BIT;
+        }
+        else if(plane == 1)
+        {
+            aspectPlane = VK_IMAGE_ASPECT_PLANE_1_BIT;
+        }
+        else if(plane == 2)
+        {
+            aspectPlane = VK_IMAGE_ASPECT_PLANE_2_BIT;
         }
 
-        skipMip = 0;
-        twidth = 0;
-        theight = 0;
-        tdepth = 0;
+        assert(aspectPlane != VK_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM);
+        return aspectPlane;
+    }
 
-        size_t NumBytes = 0;
-        size_t RowBytes = 0;
-        const uint8_t* pEndBits = bitData + bitSize;
+    //--------------------------------------------------------------------------------------
+    // The window of mip levels and array layers to load
+    //--------------------------------------------------------------------------------------
+    struct SubresourceRange
+    {
+        size_t BaseMip    = 0;
+        size_t MipCount   = 0;
+        size_t BaseLayer  = 0;
+        size_t LayerCount = 0;
+    };
 
-        initData.clear();
+    //--------------------------------------------------------------------------------------
+    // Resolves the requested subresource range against the file mip count and array size.
+    // The whole image is selected if subresourceRange is null
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetSubresourceRange(const VkImageSubresourceRange* subresourceRange, size_t mipCount, size_t arraySize, SubresourceRange& range) noexcept
+    {
+        range.BaseMip    = 0;
+        range.MipCount   = mipCount;
+        range.BaseLayer  = 0;
+        range.LayerCount = arraySize;
 
-        for (size_t p = 0; p < numberOfPlanes; ++p)
+        if (!subresourceRange)
         {
-            VkImageAspectFlags aspectPlane = VK_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM;
-            if(numberOfPlanes == 1 && !IsDepthStencil(format))
-            {
-                aspectPlane = VK_IMAGE_ASPECT_COLOR_BIT;
-            }
-            else if(numberOfPlanes == 1)
-            {
-                //No separate depth/stencil
-                aspectPlane = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
-            }
-            else if(p == 0)
-            {
-                aspectPlane = VK_IMAGE_ASPECT_PLANE_0_BIT;
-            }
-            else if(p == 1)
+            return DDS_LOADER_SUCCESS;
+        }
+
+        if (subresourceRange->baseMipLevel >= mipCount || subresourceRange->baseArrayLayer >= arraySize)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        range.BaseMip   = subresourceRange->baseMipLevel;
+        range.BaseLayer = subresourceRange->baseArrayLayer;
+
+        if (subresourceRange->levelCount != VK_REMAINING_MIP_LEVELS)
+        {
+            if (subresourceRange->levelCount == 0 || subresourceRange->levelCount > mipCount - range.BaseMip)
             {
-                aspectPlane = VK_IMAGE_ASPECT_PLANE_1_BIT;
+                return DDS_LOADER_INVALID_ARG;
             }
-            else if(p == 2)
+
+            range.MipCount = subresourceRange->levelCount;
+        }
+        else
+        {
+            range.MipCount = mipCount - range.BaseMip;
+        }
+
+        if (subresourceRange->layerCount != VK_REMAINING_ARRAY_LAYERS)
+        {
+            if (subresourceRange->layerCount == 0 || subresourceRange->layerCount > arraySize - range.BaseLayer)
             {
-                aspectPlane = VK_IMAGE_ASPECT_PLANE_2_BIT;
+                return DDS_LOADER_INVALID_ARG;
             }
 
-            assert(aspectPlane != VK_IMAGE_ASPECT_FLAG_BITS_MAX_ENUM);
+            range.LayerCount = subresourceRange->layerCount;
+        }
+        else
+        {
+            range.LayerCount = arraySize - range.BaseLayer;
+        }
 
-            const uint8_t* pSrcBits = bitData;
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Calls visit(plane, aspect, layer, mip, w, h, d, offset, byteSize) for every subresource in the data order
+    // (plane, array layer, mip level), with offset from the start of the subresource data. The planes are stored
+    // one after another, as DirectXTex writes them. totalByteSize is the size of all subresource data.
+    //--------------------------------------------------------------------------------------
+    template<typename Visitor>
+    DDS_LOADER_RESULT VisitDataSubresources(size_t width,
+        size_t height,
+        size_t depth,
+        size_t mipCount,
+        size_t arraySize,
+        size_t numberOfPlanes,
+        VkFormat format,
+        size_t& totalByteSize,
+        Visitor&& visit)
+    {
+        totalByteSize = 0;
 
+        size_t srcOffset = 0;
+        for (size_t p = 0; p < numberOfPlanes; ++p)
+        {
+            const VkImageAspectFlags aspectPlane = GetPlaneAspect(format, numberOfPlanes, p);
             for (size_t j = 0; j < arraySize; j++)
             {
-                size_t w = width;
-                size_t h = height;
-                size_t d = depth;
-                
                 for (size_t i = 0; i < mipCount; i++)
                 {
-                    DDS_LOADER_RESULT surfInfoRes = GetSurfaceInfo(w, h, format, aspectPlane, &NumBytes, &RowBytes, nullptr);
+                    const size_t w = std::max<size_t>(width  >> i, 1);
+                    const size_t h = std::max<size_t>(height >> i, 1);
+                    const size_t d = std::max<size_t>(depth  >> i, 1);
+
+                    size_t NumBytes = 0;
+                    DDS_LOADER_RESULT surfInfoRes = GetSurfaceInfo(w, h, format, aspectPlane, &NumBytes, nullptr, nullptr);
                     if(surfInfoRes != DDS_LOADER_SUCCESS)
                     {
                         return surfInfoRes;
                     }
 
-                    if(NumBytes > UINT32_MAX)
+                    if(NumBytes > SIZE_MAX / d || NumBytes * d > SIZE_MAX - srcOffset)
                     {
                         return DDS_LOADER_ARITHMETIC_OVERFLOW;
                     }
 
-                    size_t dataSize = NumBytes * d;
-
-                    if ((mipCount <= 1) || !maxsize || (w <= maxsize && h <= maxsize && d <= maxsize))
-                    {
-                        if (!twidth)
-                        {
-                            twidth  = w;
-                            theight = h;
-                            tdepth  = d;
-                        }
-
-                        LoadedSubresourceData res;
-                        res.PData                       = pSrcBits;
-                        res.DataByteSize                = dataSize;
-                        res.SubresourceSlice.aspectMask = aspectPlane;
-                        res.SubresourceSlice.arrayLayer = (uint32_t)j;
-                        res.SubresourceSlice.mipLevel   = (uint32_t)i;
-                        res.Extent.width                = (uint32_t)w;
-                        res.Extent.height               = (uint32_t)h;
-                        res.Extent.depth                = (uint32_t)d;
-
-                        initData.emplace_back(res);
-                    }
-                    else if (!j)
-                    {
-                        // Count number of skipped mipmaps (first item only)
-                        ++skipMip;
-                    }
+                    const size_t dataSize = NumBytes * d;
 
-                    if(pSrcBits + (NumBytes*d) > pEndBits)
+                    DDS_LOADER_RESULT visitRes = visit(p, aspectPlane, j, i, w, h, d, srcOffset, dataSize);
+                    if(visitRes != DDS_LOADER_SUCCESS)
                     {
-                        return DDS_LOADER_UNEXPECTED_EOF;
+                        return visitRes;
                     }
 
-                    pSrcBits += NumBytes * d;
-
-                    w = w >> 1;
-                    h = h >> 1;
-                    d = d >> 1;
-                    if (w == 0)
-                    {
-                        w = 1;
-                    }
-                    if (h == 0)
-                    {
-                        h = 1;
-                    }
-                    if (d == 0)
-                    {
-                        d = 1;
-                    }
+                    srcOffset += dataSize;
                 }
             }
         }
 
-        return initData.empty() ? DDS_LOADER_FAIL : DDS_LOADER_SUCCESS;
+        totalByteSize = srcOffset;
+        return DDS_LOADER_SUCCESS;
     }
 
-
     //--------------------------------------------------------------------------------------
-    DDS_LOADER_RESULT CreateTextureResource(
-        VkDevice vkDevice,
-        VkImageType imgType,
-        size_t width,
+    // Fills the subresources of the range. bitData holds bitSize bytes of the subresource data, starting at bitDataOffset.
+    // All of the subresource data is totalBitSize bytes, only the selected subresources have to be in bitData.
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT FillInitData(size_t width,
         size_t height,
         size_t depth,
         size_t mipCount,
         size_t arraySize,
+        size_t numberOfPlanes,
         VkFormat format,
-        VkImageUsageFlags usageFlags,
-        VkImageCreateFlags createFlags,
-        unsigned int loadFlags,
-        const VkAllocationCallbacks* allocator,
-        VkImage* texture,
-        VkImageCreateInfo* outImageCreateInfo) noexcept
+        size_t maxsize,
+        size_t bitSize,
+        const uint8_t* bitData,
+        size_t bitDataOffset,
+        size_t totalBitSize,
+        const SubresourceRange& range,
+        size_t& twidth,
+        size_t& theight,
+        size_t& tdepth,
+        size_t& skipMip,
+        std::vector<LoadedSubresourceData>& initData)
     {
-        if (!vkDevice)
+        if (!bitData)
+        {
             return DDS_LOADER_BAD_POINTER;
+        }
 
-        DDS_LOADER_RESULT result = DDS_LOADER_FAIL;
+        skipMip = 0;
+        twidth = 0;
+        theight = 0;
+        tdepth = 0;
 
-        if(loadFlags & DDS_LOADER_FORCE_SRGB)
+        initData.clear();
+
+        size_t totalByteSize = 0;
+        DDS_LOADER_RESULT errCode = VisitDataSubresources(width, height, depth, mipCount, arraySize, numberOfPlanes, format, totalByteSize,
+            [&](size_t p, VkImageAspectFlags aspectPlane, size_t j, size_t i, size_t w, size_t h, size_t d, size_t srcOffset, size_t dataSize)
         {
-            format = MakeSRGB(format);
-        }
+            if(dataSize > totalBitSize || srcOffset > totalBitSize - dataSize)
+            {
+                return DDS_LOADER_UNEXPECTED_EOF;
+            }
 
-        VkImageCreateInfo imageCreateInfo;
-        imageCreateInfo.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        imageCreateInfo.pNext                 = nullptr;
-        imageCreateInfo.flags                 = createFlags;
-        imageCreateInfo.imageType             = imgType;
-        imageCreateInfo.format                = format;
-        imageCreateInfo.extent.width          = static_cast<uint32_t>(width);
-        imageCreateInfo.extent.height         = static_cast<uint32_t>(height);
-        imageCreateInfo.extent.depth          = static_cast<uint32_t>(depth);
-        imageCreateInfo.mipLevels             = static_cast<uint32_t>(mipCount);
-        imageCreateInfo.arrayLayers           = static_cast<uint32_t>(arraySize);
-        imageCreateInfo.samples               = VK_SAMPLE_COUNT_1_BIT;
-        imageCreateInfo.tiling                = VK_IMAGE_TILING_OPTIMAL;
-        imageCreateInfo.usage                 = usageFlags;
-        imageCreateInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
-        imageCreateInfo.queueFamilyIndexCount = 0;
-        imageCreateInfo.pQueueFamilyIndices   = nullptr;
-        imageCreateInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        if(outImageCreateInfo != nullptr)
-        {
-            *outImageCreateInfo = imageCreateInfo;
-        }
+            const bool isSelected = j >= range.BaseLayer && j < range.BaseLayer + range.LayerCount
+                                 && i >= range.BaseMip   && i < range.BaseMip + range.MipCount;
+            if (isSelected && ((range.MipCount <= 1) || !maxsize || (w <= maxsize && h <= maxsize && d <= maxsize)))
+            {
+                if (srcOffset < bitDataOffset || srcOffset - bitDataOffset > bitSize || dataSize > bitSize - (srcOffset - bitDataOffset))
+                {
+                    return DDS_LOADER_UNEXPECTED_EOF;
+                }
 
-        if(vkCreateImage != nullptr)
-        {
-            VkResult vkRes = vkCreateImage(vkDevice, &imageCreateInfo, allocator, texture);
+                if (!twidth)
+                {
+                    twidth  = w;
+                    theight = h;
+                    tdepth  = d;
+                }
 
-            //This function only returns VK_SUCCESS, VK_ERROR_OUT_OF_HOST_MEMORY, VK_ERROR_OUT_OF_DEVICE_MEMORY
-            switch(vkRes)
+                LoadedSubresourceData res;
+                res.PData                       = bitData + (srcOffset - bitDataOffset);
+                res.DataByteSize                = dataSize;
+                res.SubresourceSlice.aspectMask = aspectPlane;
+                res.SubresourceSlice.arrayLayer = (uint32_t)j;
+                res.SubresourceSlice.mipLevel   = (uint32_t)i;
+                res.Extent.width                = (uint32_t)w;
+                res.Extent.height               = (uint32_t)h;
+                res.Extent.depth                = (uint32_t)d;
+
+                initData.emplace_back(res);
+            }
+            else if (isSelected && j == range.BaseLayer && p == 0)
             {
-            case VK_SUCCESS:
-                result = DDS_LOADER_SUCCESS;
-                break;
-            case VK_ERROR_OUT_OF_HOST_MEMORY:
-                result = DDS_LOADER_NO_HOST_MEMORY;
-                break;
-            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
-                result = DDS_LOADER_NO_DEVICE_MEMORY;
-                break;
-            default:
-                break;
+                // Count number of skipped mipmaps (first item only)
+                ++skipMip;
             }
-        }
-        else
-        {
-            result = DDS_LOADER_NO_FUNCTION;
-        }
 
-        if(result == DDS_LOADER_SUCCESS)
+            return DDS_LOADER_SUCCESS;
+        });
+        if (errCode != DDS_LOADER_SUCCESS)
         {
-            assert(texture != nullptr && *texture != nullptr);
-
-            SetDebugObjectName(vkDevice, *texture, "DDSTextureLoader");
+            return errCode;
         }
 
-        return result;
+        return initData.empty() ? DDS_LOADER_FAIL : DDS_LOADER_SUCCESS;
     }
 
+
     //--------------------------------------------------------------------------------------
-    DDS_LOADER_RESULT CreateTextureFromDDS(VkDevice vkDevice,
-        const DDS_HEADER* header,
-        const uint8_t* bitData,
-        size_t bitSize,
-        size_t maxsize,
-        const VkPhysicalDeviceLimits* deviceLimits,
-        VkImageUsageFlags usageFlags,
-        VkImageCreateFlags createFlags,
-        unsigned int loadFlags,
-        VkAllocationCallbacks* allocationCallbacks,
-        VkImage* texture,
-        std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
-        VkImageCreateInfo* outImageCreateInfo) noexcept(false)
+    // Gets the texel block extent and size of the single-plane format from the surface sizes
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetBlockExtent(VkFormat format, VkImageAspectFlags aspect, uint32_t* outBlockWidth, uint32_t* outBlockHeight, size_t* outBytesPerBlock) noexcept
     {
-        DDS_LOADER_RESULT errCode = DDS_LOADER_SUCCESS;
-
-        uint32_t width  = header->width;
-        uint32_t height = header->height;
-        uint32_t depth  = header->depth;
-
-        VkImageType imgType = VK_IMAGE_TYPE_2D;
-        uint32_t arraySize = 1;
-        VkFormat format = VK_FORMAT_UNDEFINED;
+        constexpr uint32_t maxBlockExtent = 16;
 
-        size_t mipCount = header->mipMapCount;
-        if (0 == mipCount)
+        size_t blockRowBytes = 0;
+        size_t blockRowCount = 0;
+        DDS_LOADER_RESULT surfInfoRes = GetSurfaceInfo(1, 1, format, aspect, nullptr, &blockRowBytes, &blockRowCount);
+        if (surfInfoRes != DDS_LOADER_SUCCESS)
         {
-            mipCount = 1;
+            return surfInfoRes;
         }
 
-        //Minimal guaranteed supported limits (refer to Table 49. Required Limits in Vulkan specification)
-        uint32_t maxImageArrayLayers   = 256;
-        uint32_t maxImageDimension1D   = 4096;
-        uint32_t maxImageDimension2D   = 4096;
-        uint32_t maxImageDimension3D   = 256;
-        uint32_t maxImageDimensionCube = 4096;
-        if(deviceLimits)
+        // The block extent is the largest size that still fits into a single block
+        uint32_t blockWidth  = 1;
+        uint32_t blockHeight = 1;
+        for (uint32_t size = 2; size <= maxBlockExtent; size++)
         {
-            maxImageArrayLayers   = deviceLimits->maxImageArrayLayers;
-            maxImageDimension1D   = deviceLimits->maxImageDimension1D;
-            maxImageDimension2D   = deviceLimits->maxImageDimension2D;
-            maxImageDimension3D   = deviceLimits->maxImageDimension3D;
-            maxImageDimensionCube = deviceLimits->maxImageDimensionCube;
-        }
+            size_t rowBytes = 0;
+            size_t rowCount = 0;
+            GetSurfaceInfo(size, size, format, aspect, nullptr, &rowBytes, &rowCount);
 
-        VkImageCreateFlags imageCreateFlags = createFlags;
+            blockWidth  = (rowBytes == blockRowBytes) ? size : blockWidth;
+            blockHeight = (rowCount == blockRowCount) ? size : blockHeight;
+        }
 
-        if ((header->ddspf.flags & DDS_FOURCC) &&
-            (MAKEFOURCC('D', 'X', '1', '0') == header->ddspf.fourCC))
-        {
-            auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>(reinterpret_cast<const char*>(header) + sizeof(DDS_HEADER));
+        *outBlockWidth    = blockWidth;
+        *outBlockHeight   = blockHeight;
+        *outBytesPerBlock = blockRowBytes;
+        return DDS_LOADER_SUCCESS;
+    }
 
-            arraySize = d3d10ext->arraySize;
-            if(arraySize == 0)
-            {
-                return DDS_LOADER_INVALID_DATA;
-            }
+    //--------------------------------------------------------------------------------------
+    // Finds the part [spanBegin, spanEnd) of the subresource data that holds all subresources of the range,
+    // in the same data order as FillInitData. totalByteSize is the size of all subresource data.
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetSubresourceDataSpan(size_t width,
+        size_t height,
+        size_t depth,
+        size_t mipCount,
+        size_t arraySize,
+        size_t numberOfPlanes,
+        VkFormat format,
+        const SubresourceRange& range,
+        size_t& spanBegin,
+        size_t& spanEnd,
+        size_t& totalByteSize)
+    {
+        spanBegin     = SIZE_MAX;
+        spanEnd       = 0;
 
-            if(IsTypelessFormat(d3d10ext->dxgiFormat))
+        DDS_LOADER_RESULT errCode = VisitDataSubresources(width, height, depth, mipCount, arraySize, numberOfPlanes, format, totalByteSize,
+            [&](size_t, VkImageAspectFlags, size_t j, size_t i, size_t, size_t, size_t, size_t srcOffset, size_t dataSize)
+        {
+            if (j >= range.BaseLayer && j < range.BaseLayer + range.LayerCount
+             && i >= range.BaseMip   && i < range.BaseMip + range.MipCount)
             {
-                imageCreateFlags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+                spanBegin = std::min(spanBegin, srcOffset);
+                spanEnd   = std::max(spanEnd, srcOffset + dataSize);
             }
 
-            format = DXGIToVkFormat(d3d10ext->dxgiFormat);
-            if(BitsPerPixel(format) == 0)
-            {
-                return DDS_LOADER_UNSUPPORTED_FORMAT;
-            }
+            return DDS_LOADER_SUCCESS;
+        });
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
 
-            VkImageType imgTypeFromResDim = D3DResourceDimensionToImageType(d3d10ext->resourceDimension);
-            switch(imgTypeFromResDim)
-            {
-            case VK_IMAGE_TYPE_1D:
-                // D3DX writes 1D textures with a fixed Height of 1
-                if ((header->flags & DDS_HEIGHT) && height != 1)
-                {
-                    return DDS_LOADER_INVALID_DATA;
-                }
-                height = depth = 1;
-                break;
+        if (spanBegin > spanEnd)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
 
-            case VK_IMAGE_TYPE_2D:
-                if (d3d10ext->miscFlag & 0x4 /* RESOURCE_MISC_TEXTURECUBE */)
-                {
-                    imageCreateFlags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-                    arraySize *= 6;
-                }
+        return DDS_LOADER_SUCCESS;
+    }
 
-                if(arraySize > 1)
-                {
-                    imageCreateFlags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
-                }
+    //--------------------------------------------------------------------------------------
+    // Finds the maxsize value for FillInitData that drops just enough top mips for the image data
+    // to fit into budgetByteSize. Returns 0 in maxsize if the whole mip chain fits.
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetBudgetMaxSize(size_t width,
+        size_t height,
+        size_t depth,
+        size_t mipCount,
+        size_t arraySize,
+        size_t numberOfPlanes,
+        VkFormat format,
+        size_t budgetByteSize,
+        size_t& maxsize)
+    {
+        maxsize = 0;
 
-                depth = 1;
-                break;
+        // Sum the sizes from the smallest mip up, the dropped mips are always the largest ones
+        std::vector<size_t> mipDimensions(mipCount);
+        std::vector<size_t> mipByteSizes(mipCount);
 
-            case VK_IMAGE_TYPE_3D:
-                if (!(header->flags & DDS_HEADER_FLAGS_VOLUME))
+        size_t w = width;
+        size_t h = height;
+        size_t d = depth;
+        for (size_t i = 0; i < mipCount; i++)
+        {
+            size_t mipByteSize = 0;
+            for (size_t p = 0; p < numberOfPlanes; ++p)
+            {
+                size_t NumBytes = 0;
+                DDS_LOADER_RESULT surfInfoRes = GetSurfaceInfo(w, h, format, GetPlaneAspect(format, numberOfPlanes, p), &NumBytes, nullptr, nullptr);
+                if(surfInfoRes != DDS_LOADER_SUCCESS)
                 {
-                    return DDS_LOADER_INVALID_DATA;
+                    return surfInfoRes;
                 }
 
-                if (arraySize > 1)
+                if(NumBytes > SIZE_MAX / d || NumBytes * d > SIZE_MAX / arraySize || NumBytes * d * arraySize > SIZE_MAX - mipByteSize)
                 {
-                    return DDS_LOADER_UNSUPPORTED_LAYOUT;
+                    return DDS_LOADER_ARITHMETIC_OVERFLOW;
                 }
-                break;
-
-            default:
-                return DDS_LOADER_UNSUPPORTED_LAYOUT;
-            }
-
-            imgType = imgTypeFromResDim;
-        }
-        else
-        {
-            format = GetVkFormat(header->ddspf);
-
-            if(format == VK_FORMAT_UNDEFINED)
-            {
-                return DDS_LOADER_UNSUPPORTED_FORMAT;
-            }
 
-            if(header->flags & DDS_HEADER_FLAGS_VOLUME)
-            {
-                imgType = VK_IMAGE_TYPE_3D;
+                mipByteSize += NumBytes * d * arraySize;
             }
-            else
-            {
-                if (header->caps2 & DDS_CUBEMAP)
-                {
-                    // We require all six faces to be defined
-                    if ((header->caps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
-                    {
-                        return DDS_LOADER_UNSUPPORTED_LAYOUT;
-                    }
 
-                    arraySize = 6;
-                    imageCreateFlags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-                }
+            mipDimensions[i] = std::max(std::max(w, h), d);
+            mipByteSizes[i]  = mipByteSize;
 
-                depth = 1;
-                imgType = VK_IMAGE_TYPE_2D;
+            w = std::max<size_t>(w >> 1, 1);
+            h = std::max<size_t>(h >> 1, 1);
+            d = std::max<size_t>(d >> 1, 1);
+        }
 
-                // Note there's no way for a legacy Direct3D 9 DDS to express a '1D' texture
-            }
+        size_t byteSize = 0;
+        size_t firstMip = mipCount;
+        while (firstMip > 0 && mipByteSizes[firstMip - 1] <= budgetByteSize - byteSize)
+        {
+            firstMip--;
+            byteSize += mipByteSizes[firstMip];
+        }
 
-            assert(BitsPerPixel(format) != 0);
+        // FillInitData never drops the only mip
+        if (firstMip == mipCount || (firstMip != 0 && mipCount <= 1))
+        {
+            return DDS_LOADER_NO_DEVICE_MEMORY;
         }
 
-        // Bound sizes (for security purposes we don't trust DDS file metadata larger than the Direct3D hardware requirements)
-        // Vulkan does not have an easy way to obtain this informtation - there's no corresponding VkPhysicalDeviceLimits entry
-        constexpr uint32_t maxDirect3DMips = 15;
-        if (mipCount > maxDirect3DMips /*D3D12_REQ_MIP_LEVELS*/ )
+        if (firstMip != 0)
         {
-            return DDS_LOADER_UNSUPPORTED_LAYOUT;
+            maxsize = mipDimensions[firstMip];
         }
 
-        switch (imgType)
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Runs func(begin, end) on the [0, count) range split between the hardware threads.
+    // Ranges shorter than minRange are not split further.
+    //--------------------------------------------------------------------------------------
+    template<typename Func>
+    void ParallelFor(size_t count, size_t minRange, const Func& func)
+    {
+        minRange = std::max<size_t>(minRange, 1);
+
+        size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        threadCount = std::min(threadCount, (count + minRange - 1) / minRange);
+        if (threadCount <= 1)
         {
-        case VK_IMAGE_TYPE_1D:
-            if ((arraySize > maxImageArrayLayers) ||
-                (width > maxImageDimension1D))
-            {
-                return DDS_LOADER_BELOW_LIMITS;
-            }
-            break;
+            func(size_t(0), count);
+            return;
+        }
 
-        case VK_IMAGE_TYPE_2D:
-            if (imageCreateFlags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
-            {
-                // This is the right bound because we set arraySize to (NumCubes*6) above
-                if ((arraySize > maxImageArrayLayers) ||
-                    (width > maxImageDimensionCube) ||
-                    (height > maxImageDimensionCube))
-                {
-                    return DDS_LOADER_BELOW_LIMITS;
-                }
-            }
-            else if ((arraySize > maxImageArrayLayers) ||
-                     (width > maxImageDimension2D) ||
-                     (height > maxImageDimension2D))
-            {
-                return DDS_LOADER_BELOW_LIMITS;
-            }
-            break;
+        const size_t rangeSize = (count + threadCount - 1) / threadCount;
 
-        case VK_IMAGE_TYPE_3D:
-            if ((arraySize > 1) ||
-                (width > maxImageDimension3D) ||
-                (height > maxImageDimension3D) ||
-                (depth > maxImageDimension3D))
+        std::vector<std::thread> threads;
+        size_t launchedEnd = rangeSize;
+        try
+        {
+            threads.reserve(threadCount - 1);
+            while (launchedEnd < count)
             {
-                return DDS_LOADER_BELOW_LIMITS;
+                const size_t begin = launchedEnd;
+                const size_t end   = std::min(count, begin + rangeSize);
+                threads.emplace_back([&func, begin, end]() { func(begin, end); });
+                launchedEnd = end;
             }
-            break;
-
-        default:
-            return DDS_LOADER_UNSUPPORTED_LAYOUT;
+        }
+        catch (const std::exception&)
+        {
+            // Could not start the thread, process the rest on the calling thread
         }
 
-        uint32_t numberOfPlanes = GetVkFormatPlaneCount(format);
-        if(numberOfPlanes == 0)
+        func(size_t(0), rangeSize);
+        if (launchedEnd < count)
         {
-            return DDS_LOADER_UNSUPPORTED_FORMAT;
+            func(launchedEnd, count);
         }
 
-        if ((numberOfPlanes > 1) && IsDepthStencil(format))
+        for (std::thread& thread : threads)
         {
-            // For the future (at the moment of writing this Vulkan doesn't have any multi-planar depth-stencil format support)
-            return DDS_LOADER_UNSUPPORTED_FORMAT;
+            thread.join();
         }
+    }
 
-        // Create the texture
-        size_t numberOfResources = (imgType == VK_IMAGE_TYPE_3D)
-                                   ? 1 : arraySize;
-        numberOfResources *= mipCount;
-        numberOfResources *= numberOfPlanes;
+    //--------------------------------------------------------------------------------------
+    inline uint8_t ClampToByte(int value) noexcept
+    {
+        return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+    }
 
-        //Vulkan doesn't have any subresource number limit
-        subresources.reserve(numberOfResources);
+    //--------------------------------------------------------------------------------------
+    // ETC2/EAC block decompression
+    // See "ETC2 Compressed Texture Image Formats" in the Khronos Data Format Specification
+    //--------------------------------------------------------------------------------------
+    constexpr int Etc1ModifierTable[8][2] =
+    {
+        {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+    };
 
-        size_t skipMip = 0;
-        size_t twidth = 0;
+    constexpr int Etc2DistanceTable[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+    constexpr int EacModifierTable[16][8] =
+    {
+        {-3, -6,  -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5,  -8, -13, 1, 4, 7, 12},
+        {-2, -4,  -6, -13, 1, 3, 5, 12},
+        {-3, -6,  -8, -12, 2, 5, 7, 11},
+        {-3, -7,  -9, -11, 2, 6, 8, 10},
+        {-4, -7,  -8, -11, 3, 6, 7, 10},
+        {-3, -5,  -8, -11, 2, 4, 7, 10},
+        {-2, -6,  -8, -10, 1, 5, 7,  9},
+        {-2, -5,  -8, -10, 1, 4, 7,  9},
+        {-2, -4,  -8, -10, 1, 3, 7,  9},
+        {-2, -5,  -7, -10, 1, 4, 6,  9},
+        {-3, -4,  -7, -10, 2, 3, 6,  9},
+        {-1, -2,  -3, -10, 0, 1, 2,  9},
+        {-4, -6,  -8,  -9, 3, 5, 7,  8},
+        {-3, -5,  -7,  -9, 2, 4, 6,  8}
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Decodes ETC2 RGB or RGB punch-through alpha block into 4x4 R8G8B8A8 texels, row-major
+    //--------------------------------------------------------------------------------------
+    void DecodeEtc2ColorBlock(const uint8_t* block, bool punchthroughAlpha, uint8_t* texels) noexcept
+    {
+        const uint32_t indexBits = (uint32_t(block[4]) << 24) | (uint32_t(block[5]) << 16) | (uint32_t(block[6]) << 8) | uint32_t(block[7]);
+
+        // Punch-through alpha blocks reuse the differential bit as the opaque bit and are always differential
+        const bool differential = punchthroughAlpha || (block[3] & 0x2);
+        const bool opaque       = !punchthroughAlpha || (block[3] & 0x2);
+
+        // Pixel indices are stored column-major, most significant bits first
+        auto pixelIndex = [indexBits](uint32_t x, uint32_t y)
+        {
+            const uint32_t i = x * 4 + y;
+            return (((indexBits >> (i + 16)) & 1) << 1) | ((indexBits >> i) & 1);
+        };
+
+        auto writeTexel = [texels](uint32_t x, uint32_t y, int r, int g, int b, int a)
+        {
+            uint8_t* texel = texels + (y * 4 + x) * 4;
+            texel[0] = ClampToByte(r);
+            texel[1] = ClampToByte(g);
+            texel[2] = ClampToByte(b);
+            texel[3] = ClampToByte(a);
+        };
+
+        auto extend4 = [](int value) { return (value << 4) | value; };
+        auto extend5 = [](int value) { return (value << 3) | (value >> 2); };
+        auto extend6 = [](int value) { return (value << 2) | (value >> 4); };
+        auto extend7 = [](int value) { return (value << 1) | (value >> 6); };
+
+        int baseColors[2][3];
+        if (differential)
+        {
+            const int r = block[0] >> 3;
+            const int g = block[1] >> 3;
+            const int b = block[2] >> 3;
+
+            const int dr = int(block[0] & 0x7) - ((block[0] & 0x4) << 1);
+            const int dg = int(block[1] & 0x7) - ((block[1] & 0x4) << 1);
+            const int db = int(block[2] & 0x7) - ((block[2] & 0x4) << 1);
+
+            if (r + dr < 0 || r + dr > 31 || g + dg < 0 || g + dg > 31)
+            {
+                int paintColors[4][3];
+                if (r + dr < 0 || r + dr > 31)
+                {
+                    // T mode
+                    const int c0[3] = {extend4(((block[0] >> 1) & 0xC) | (block[0] & 0x3)), extend4(block[1] >> 4), extend4(block[1] & 0xF)};
+                    const int c1[3] = {extend4(block[2] >> 4), extend4(block[2] & 0xF), extend4(block[3] >> 4)};
+
+                    const int distance = Etc2DistanceTable[((block[3] >> 1) & 0x6) | (block[3] & 0x1)];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paintColors[0][c] = c0[c];
+                        paintColors[1][c] = c1[c] + distance;
+                        paintColors[2][c] = c1[c];
+                        paintColors[3][c] = c1[c] - distance;
+                    }
+                }
+                else
+                {
+                    // H mode
+                    const int r0 = (block[0] >> 3) & 0xF;
+                    const int g0 = ((block[0] & 0x7) << 1) | ((block[1] >> 4) & 0x1);
+                    const int b0 = (block[1] & 0x8) | ((block[1] & 0x3) << 1) | (block[2] >> 7);
+                    const int r1 = (block[2] >> 3) & 0xF;
+                    const int g1 = ((block[2] & 0x7) << 1) | (block[3] >> 7);
+                    const int b1 = (block[3] >> 3) & 0xF;
+
+                    const int c0[3] = {extend4(r0), extend4(g0), extend4(b0)};
+                    const int c1[3] = {extend4(r1), extend4(g1), extend4(b1)};
+
+                    // The last bit of the distance index is implicit in the order of the base colors
+                    int distanceIndex = (block[3] & 0x4) | ((block[3] & 0x1) << 1);
+                    if (((c0[0] << 16) | (c0[1] << 8) | c0[2]) >= ((c1[0] << 16) | (c1[1] << 8) | c1[2]))
+                    {
+                        distanceIndex |= 1;
+                    }
+
+                    const int distance = Etc2DistanceTable[distanceIndex];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        paintColors[0][c] = c0[c] + distance;
+                        paintColors[1][c] = c0[c] - distance;
+                        paintColors[2][c] = c1[c] + distance;
+                        paintColors[3][c] = c1[c] - distance;
+                    }
+                }
+
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    for (uint32_t x = 0; x < 4; ++x)
+                    {
+                        const uint32_t index = pixelIndex(x, y);
+                        if (!opaque && index == 2)
+                        {
+                            writeTexel(x, y, 0, 0, 0, 0);
+                        }
+                        else
+                        {
+                            writeTexel(x, y, paintColors[index][0], paintColors[index][1], paintColors[index][2], 255);
+                        }
+                    }
+                }
+
+                return;
+            }
+
+            if (b + db < 0 || b + db > 31)
+            {
+                // Planar mode, always opaque
+                const int ro = extend6((block[0] >> 1) & 0x3F);
+                const int go = extend7(((block[0] & 0x1) << 6) | ((block[1] >> 1) & 0x3F));
+                const int bo = extend6(((block[1] & 0x1) << 5) | (block[2] & 0x18) | ((block[2] & 0x3) << 1) | (block[3] >> 7));
+                const int rh = extend6(((block[3] >> 1) & 0x3E) | (block[3] & 0x1));
+                const int gh = extend7(block[4] >> 1);
+                const int bh = extend6(((block[4] & 0x1) << 5) | (block[5] >> 3));
+                const int rv = extend6(((block[5] & 0x7) << 3) | (block[6] >> 5));
+                const int gv = extend7(((block[6] & 0x1F) << 2) | (block[7] >> 6));
+                const int bv = extend6(block[7] & 0x3F);
+
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    for (uint32_t x = 0; x < 4; ++x)
+                    {
+                        const int ix = int(x);
+                        const int iy = int(y);
+                        writeTexel(x, y,
+                            (ix * (rh - ro) + iy * (rv - ro) + 4 * ro + 2) >> 2,
+                            (ix * (gh - go) + iy * (gv - go) + 4 * go + 2) >> 2,
+                            (ix * (bh - bo) + iy * (bv - bo) + 4 * bo + 2) >> 2,
+                            255);
+                    }
+                }
+
+                return;
+            }
+
+            baseColors[0][0] = extend5(r);
+            baseColors[0][1] = extend5(g);
+            baseColors[0][2] = extend5(b);
+            baseColors[1][0] = extend5(r + dr);
+            baseColors[1][1] = extend5(g + dg);
+            baseColors[1][2] = extend5(b + db);
+        }
+        else
+        {
+            baseColors[0][0] = extend4(block[0] >> 4);
+            baseColors[0][1] = extend4(block[1] >> 4);
+            baseColors[0][2] = extend4(block[2] >> 4);
+            baseColors[1][0] = extend4(block[0] & 0xF);
+            baseColors[1][1] = extend4(block[1] & 0xF);
+            baseColors[1][2] = extend4(block[2] & 0xF);
+        }
+
+        const int  tableIndices[2] = {block[3] >> 5, (block[3] >> 2) & 0x7};
+        const bool flip            = (block[3] & 0x1) != 0;
+
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            for (uint32_t x = 0; x < 4; ++x)
+            {
+                const uint32_t subblock = flip ? (y >> 1) : (x >> 1);
+                const uint32_t index    = pixelIndex(x, y);
+                if (!opaque && index == 2)
+                {
+                    writeTexel(x, y, 0, 0, 0, 0);
+                    continue;
+                }
+
+                // Index 0 means +a, 1 means +b, 2 means -a, 3 means -b. Non-opaque punch-through blocks don't use 'a'
+                int modifier = Etc1ModifierTable[tableIndices[subblock]][index & 0x1];
+                if (!opaque && index == 0)
+                {
+                    modifier = 0;
+                }
+                if (index & 0x2)
+                {
+                    modifier = -modifier;
+                }
+
+                const int* baseColor = baseColors[subblock];
+                writeTexel(x, y, baseColor[0] + modifier, baseColor[1] + modifier, baseColor[2] + modifier, 255);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decodes EAC block into the alpha channel of 4x4 R8G8B8A8 texels, row-major
+    //--------------------------------------------------------------------------------------
+    void DecodeEtc2AlphaBlock(const uint8_t* block, uint8_t* texels) noexcept
+    {
+        const int  base       = block[0];
+        const int  multiplier = block[1] >> 4;
+        const int* modifiers  = EacModifierTable[block[1] & 0xF];
+
+        uint64_t indexBits = 0;
+        for (uint32_t i = 2; i < 8; ++i)
+        {
+            indexBits = (indexBits << 8) | block[i];
+        }
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const uint32_t x = i / 4;
+            const uint32_t y = i % 4;
+
+            const int modifier = modifiers[(indexBits >> (45 - 3 * i)) & 0x7];
+            texels[(y * 4 + x) * 4 + 3] = ClampToByte(base + modifier * multiplier);
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // ASTC block decompression (LDR profile)
+    // See "ASTC Compressed Texture Image Formats" in the Khronos Data Format Specification
+    //--------------------------------------------------------------------------------------
+    enum ASTC_QUANT_KIND : uint8_t
+    {
+        ASTC_QUANT_BITS   = 0,
+        ASTC_QUANT_TRITS  = 1,
+        ASTC_QUANT_QUINTS = 2,
+    };
+
+    // Indexed by the quantization level. The ranges are 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128, 160, 192, 256
+    constexpr uint8_t AstcQuantBits[21] = {1, 0, 2, 0, 1, 3, 1, 2, 4, 2, 3, 5, 3, 4, 6, 4, 5, 7, 5, 6, 8};
+    constexpr uint8_t AstcQuantKind[21] = {0, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0};
+
+    constexpr uint32_t AstcMinColorQuantLevel = 4; //Range of 6
+    constexpr uint32_t AstcMaxColorQuantLevel = 20;
+
+    //--------------------------------------------------------------------------------------
+    inline uint32_t GetAstcIseBitCount(uint32_t count, uint32_t quantLevel) noexcept
+    {
+        uint32_t bitCount = count * AstcQuantBits[quantLevel];
+        switch (AstcQuantKind[quantLevel])
+        {
+        case ASTC_QUANT_TRITS:
+            bitCount += (8 * count + 4) / 5;
+            break;
+        case ASTC_QUANT_QUINTS:
+            bitCount += (7 * count + 2) / 3;
+            break;
+        default:
+            break;
+        }
+
+        return bitCount;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Reads the 128-bit block as a little-endian bit stream. Reading past the end bit yields zeroes.
+    //--------------------------------------------------------------------------------------
+    struct AstcBitReader
+    {
+        uint64_t Low;
+        uint64_t High;
+        uint32_t Position;
+        uint32_t EndPosition;
+
+        uint32_t Read(uint32_t bitCount) noexcept
+        {
+            uint32_t result = 0;
+            if (Position < EndPosition && bitCount != 0)
+            {
+                uint64_t bits = 0;
+                if (Position >= 64)
+                {
+                    bits = High >> (Position - 64);
+                }
+                else
+                {
+                    bits = Low >> Position;
+                    if (Position != 0)
+                    {
+                        bits |= High << (64 - Position);
+                    }
+                }
+
+                const uint32_t availableBits = std::min(bitCount, EndPosition - Position);
+                result = static_cast<uint32_t>(bits & ((uint64_t(1) << availableBits) - 1));
+            }
+
+            Position += bitCount;
+            return result;
+        }
+    };
+
+    //--------------------------------------------------------------------------------------
+    inline uint64_t ReverseBits64(uint64_t value) noexcept
+    {
+        value = ((value >> 1)  & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+        value = ((value >> 2)  & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+        value = ((value >> 4)  & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+        value = ((value >> 8)  & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+        value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+        return (value >> 32) | (value << 32);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decodes the integer sequence of count values quantized to the given level
+    //--------------------------------------------------------------------------------------
+    void DecodeAstcIntegerSequence(uint64_t low, uint64_t high, uint32_t bitOffset, uint32_t quantLevel, uint32_t count, uint8_t* outValues) noexcept
+    {
+        AstcBitReader reader = {low, high, bitOffset, bitOffset + GetAstcIseBitCount(count, quantLevel)};
+
+        const uint32_t bits = AstcQuantBits[quantLevel];
+        switch (AstcQuantKind[quantLevel])
+        {
+        case ASTC_QUANT_TRITS:
+            for (uint32_t i = 0; i < count; i += 5)
+            {
+                // Five values share 8 bits of packed trits interleaved with their low bits
+                uint32_t m[5];
+                uint32_t T = 0;
+                m[0] = reader.Read(bits); T |= reader.Read(2);
+                m[1] = reader.Read(bits); T |= reader.Read(2) << 2;
+                m[2] = reader.Read(bits); T |= reader.Read(1) << 4;
+                m[3] = reader.Read(bits); T |= reader.Read(2) << 5;
+                m[4] = reader.Read(bits); T |= reader.Read(1) << 7;
+
+                uint32_t t[5];
+                uint32_t C = 0;
+                if (((T >> 2) & 0x7) == 0x7)
+                {
+                    C    = (((T >> 5) & 0x7) << 2) | (T & 0x3);
+                    t[4] = 2;
+                    t[3] = 2;
+                }
+                else
+                {
+                    C = T & 0x1F;
+                    if (((T >> 5) & 0x3) == 0x3)
+                    {
+                        t[4] = 2;
+                        t[3] = (T >> 7) & 0x1;
+                    }
+                    else
+                    {
+                        t[4] = (T >> 7) & 0x1;
+                        t[3] = (T >> 5) & 0x3;
+                    }
+                }
+
+                if ((C & 0x3) == 0x3)
+                {
+                    t[2] = 2;
+                    t[1] = (C >> 4) & 0x1;
+                    t[0] = (((C >> 3) & 0x1) << 1) | (((C >> 2) & 0x1) & ~((C >> 3) & 0x1));
+                }
+                else if (((C >> 2) & 0x3) == 0x3)
+                {
+                    t[2] = 2;
+                    t[1] = 2;
+                    t[0] = C & 0x3;
+                }
+                else
+                {
+                    t[2] = (C >> 4) & 0x1;
+                    t[1] = (C >> 2) & 0x3;
+                    t[0] = (((C >> 1) & 0x1) << 1) | ((C & 0x1) & ~((C >> 1) & 0x1));
+                }
+
+                for (uint32_t j = 0; j < 5 && i + j < count; ++j)
+                {
+                    outValues[i + j] = static_cast<uint8_t>((t[j] << bits) | m[j]);
+                }
+            }
+            break;
+
+        case ASTC_QUANT_QUINTS:
+            for (uint32_t i = 0; i < count; i += 3)
+            {
+                // Three values share 7 bits of packed quints interleaved with their low bits
+                uint32_t m[3];
+                uint32_t Q = 0;
+                m[0] = reader.Read(bits); Q |= reader.Read(3);
+                m[1] = reader.Read(bits); Q |= reader.Read(2) << 3;
+                m[2] = reader.Read(bits); Q |= reader.Read(2) << 5;
+
+                uint32_t q[3];
+                if (((Q >> 1) & 0x3) == 0x3 && ((Q >> 5) & 0x3) == 0)
+                {
+                    q[2] = ((Q & 0x1) << 2) | ((((Q >> 4) & 0x1) & ~(Q & 0x1)) << 1) | (((Q >> 3) & 0x1) & ~(Q & 0x1));
+                    q[1] = 4;
+                    q[0] = 4;
+                }
+                else
+                {
+                    uint32_t C = 0;
+                    if (((Q >> 1) & 0x3) == 0x3)
+                    {
+                        q[2] = 4;
+                        C    = (((Q >> 3) & 0x3) << 3) | ((~(Q >> 5) & 0x3) << 1) | (Q & 0x1);
+                    }
+                    else
+                    {
+                        q[2] = (Q >> 5) & 0x3;
+                        C    = Q & 0x1F;
+                    }
+
+                    if ((C & 0x7) == 0x5)
+                    {
+                        q[1] = 4;
+                        q[0] = (C >> 3) & 0x3;
+                    }
+                    else
+                    {
+                        q[1] = (C >> 3) & 0x3;
+                        q[0] = C & 0x7;
+                    }
+                }
+
+                for (uint32_t j = 0; j < 3 && i + j < count; ++j)
+                {
+                    outValues[i + j] = static_cast<uint8_t>((q[j] << bits) | m[j]);
+                }
+            }
+            break;
+
+        default:
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                outValues[i] = static_cast<uint8_t>(reader.Read(bits));
+            }
+            break;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Unquantizes the weight value to the [0, 64] range
+    //--------------------------------------------------------------------------------------
+    uint32_t UnquantizeAstcWeight(uint32_t quantLevel, uint32_t value) noexcept
+    {
+        const uint32_t bits = AstcQuantBits[quantLevel];
+        const uint32_t kind = AstcQuantKind[quantLevel];
+
+        uint32_t result = 0;
+        if (kind == ASTC_QUANT_BITS)
+        {
+            // Bit replication to 6 bits
+            switch (bits)
+            {
+            case 1: result = value ? 63 : 0;                          break;
+            case 2: result = (value << 4) | (value << 2) | value;     break;
+            case 3: result = (value << 3) | value;                    break;
+            case 4: result = (value << 2) | (value >> 2);             break;
+            case 5: result = (value << 1) | (value >> 4);             break;
+            default: break;
+            }
+        }
+        else if (bits == 0)
+        {
+            constexpr uint32_t tritValues[3]  = {0, 32, 63};
+            constexpr uint32_t quintValues[5] = {0, 16, 32, 47, 63};
+            result = (kind == ASTC_QUANT_TRITS) ? tritValues[value] : quintValues[value];
+        }
+        else
+        {
+            const uint32_t D = value >> bits;
+            const uint32_t A = (value & 0x1) ? 0x7F : 0x00;
+            const uint32_t b = (value >> 1) & 0x1;
+            const uint32_t c = (value >> 2) & 0x1;
+
+            uint32_t B = 0;
+            uint32_t C = 0;
+            switch (quantLevel)
+            {
+            case 4:  /* 6 */  C = 50;                                          break;
+            case 6:  /* 10 */ C = 28;                                          break;
+            case 7:  /* 12 */ C = 23; B = (b << 6) | (b << 2) | b;             break;
+            case 9:  /* 20 */ C = 13; B = (b << 6) | (b << 1) | b;             break;
+            case 10: /* 24 */ C = 11; B = (c << 6) | (b << 5) | (c << 1) | b;  break;
+            default: break;
+            }
+
+            result = D * C + B;
+            result ^= A;
+            result = (A & 0x20) | (result >> 2);
+        }
+
+        if (result > 32)
+        {
+            result += 1;
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Unquantizes the color endpoint value to the [0, 255] range
+    //--------------------------------------------------------------------------------------
+    uint32_t UnquantizeAstcColor(uint32_t quantLevel, uint32_t value) noexcept
+    {
+        const uint32_t bits = AstcQuantBits[quantLevel];
+        if (AstcQuantKind[quantLevel] == ASTC_QUANT_BITS)
+        {
+            // Bit replication to 8 bits
+            uint32_t result = 0;
+            int      shift  = 8;
+            while (shift > 0)
+            {
+                shift -= int(bits);
+                result |= (shift >= 0) ? (value << shift) : (value >> -shift);
+            }
+
+            return result & 0xFF;
+        }
+
+        const uint32_t D = value >> bits;
+        const uint32_t A = (value & 0x1) ? 0x1FF : 0x000;
+        const uint32_t b = (value >> 1) & 0x1;
+        const uint32_t c = (value >> 2) & 0x1;
+        const uint32_t d = (value >> 3) & 0x1;
+        const uint32_t e = (value >> 4) & 0x1;
+        const uint32_t f = (value >> 5) & 0x1;
+
+        uint32_t B = 0;
+        uint32_t C = 0;
+        switch (quantLevel)
+        {
+        case 4:  /* 6 */   C = 204;                                                                          break;
+        case 6:  /* 10 */  C = 113;                                                                          break;
+        case 7:  /* 12 */  C = 93;  B = (b << 8) | (b << 4) | (b << 2) | (b << 1);                          break;
+        case 9:  /* 20 */  C = 54;  B = (b << 8) | (b << 3) | (b << 2);                                     break;
+        case 10: /* 24 */  C = 44;  B = (c << 8) | (b << 7) | (c << 3) | (b << 2) | (c << 1) | b;           break;
+        case 12: /* 40 */  C = 26;  B = (c << 8) | (b << 7) | (c << 2) | (b << 1) | c;                      break;
+        case 13: /* 48 */  C = 22;  B = (d << 8) | (c << 7) | (b << 6) | (d << 2) | (c << 1) | b;           break;
+        case 15: /* 80 */  C = 13;  B = (d << 8) | (c << 7) | (b << 6) | (d << 1) | c;                      break;
+        case 16: /* 96 */  C = 11;  B = (e << 8) | (d << 7) | (c << 6) | (b << 5) | (e << 1) | d;           break;
+        case 18: /* 160 */ C = 6;   B = (e << 8) | (d << 7) | (c << 6) | (b << 5) | e;                      break;
+        case 19: /* 192 */ C = 5;   B = (f << 8) | (e << 7) | (d << 6) | (c << 5) | (b << 4) | f;           break;
+        default: break;
+        }
+
+        uint32_t result = D * C + B;
+        result ^= A;
+        return (A & 0x80) | (result >> 2);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decodes the weight grid size, weight quantization level and dual plane flag from the block mode.
+    // Returns false for reserved block modes
+    //--------------------------------------------------------------------------------------
+    bool DecodeAstcBlockMode(uint32_t blockMode, uint32_t* outGridWidth, uint32_t* outGridHeight, bool* outDualPlane, uint32_t* outWeightQuantLevel) noexcept
+    {
+        uint32_t baseQuantMode = (blockMode >> 4) & 0x1;
+        uint32_t H = (blockMode >> 9) & 0x1;
+        uint32_t D = (blockMode >> 10) & 0x1;
+        uint32_t A = (blockMode >> 5) & 0x3;
+
+        uint32_t gridWidth  = 0;
+        uint32_t gridHeight = 0;
+        if ((blockMode & 0x3) != 0)
+        {
+            baseQuantMode |= (blockMode & 0x3) << 1;
+
+            uint32_t B = (blockMode >> 7) & 0x3;
+            switch ((blockMode >> 2) & 0x3)
+            {
+            case 0:
+                gridWidth  = B + 4;
+                gridHeight = A + 2;
+                break;
+            case 1:
+                gridWidth  = B + 8;
+                gridHeight = A + 2;
+                break;
+            case 2:
+                gridWidth  = A + 2;
+                gridHeight = B + 8;
+                break;
+            default:
+                B &= 0x1;
+                if (blockMode & 0x100)
+                {
+                    gridWidth  = B + 2;
+                    gridHeight = A + 2;
+                }
+                else
+                {
+                    gridWidth  = A + 2;
+                    gridHeight = B + 6;
+                }
+                break;
+            }
+        }
+        else
+        {
+            baseQuantMode |= ((blockMode >> 2) & 0x3) << 1;
+            if (((blockMode >> 2) & 0x3) == 0)
+            {
+                return false;
+            }
+
+            const uint32_t B = (blockMode >> 9) & 0x3;
+            switch ((blockMode >> 7) & 0x3)
+            {
+            case 0:
+                gridWidth  = 12;
+                gridHeight = A + 2;
+                break;
+            case 1:
+                gridWidth  = A + 2;
+                gridHeight = 12;
+                break;
+            case 2:
+                gridWidth  = A + 6;
+                gridHeight = B + 6;
+                D = 0;
+                H = 0;
+                break;
+            default:
+                if (A == 0)
+                {
+                    gridWidth  = 6;
+                    gridHeight = 10;
+                }
+                else if (A == 1)
+                {
+                    gridWidth  = 10;
+                    gridHeight = 6;
+                }
+                else
+                {
+                    return false;
+                }
+                break;
+            }
+        }
+
+        const uint32_t weightQuantLevel = (baseQuantMode - 2) + 6 * H;
+        const uint32_t weightCount      = gridWidth * gridHeight * (D + 1);
+        const uint32_t weightBitCount   = GetAstcIseBitCount(weightCount, weightQuantLevel);
+        if (weightCount > 64 || weightBitCount < 24 || weightBitCount > 96)
+        {
+            return false;
+        }
+
+        *outGridWidth        = gridWidth;
+        *outGridHeight       = gridHeight;
+        *outDualPlane        = (D != 0);
+        *outWeightQuantLevel = weightQuantLevel;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decodes the LDR color endpoint pair. Returns false for HDR endpoint modes
+    //--------------------------------------------------------------------------------------
+    bool DecodeAstcEndpoints(uint32_t endpointMode, const uint32_t* values, int* e0, int* e1) noexcept
+    {
+        auto bitTransferSigned = [](int& a, int& b)
+        {
+            b >>= 1;
+            b |= a & 0x80;
+            a >>= 1;
+            a &= 0x3F;
+            if (a & 0x20)
+            {
+                a -= 0x40;
+            }
+        };
+
+        auto setColor = [](int* e, int r, int g, int b, int a)
+        {
+            e[0] = ClampToByte(r);
+            e[1] = ClampToByte(g);
+            e[2] = ClampToByte(b);
+            e[3] = ClampToByte(a);
+        };
+
+        int v[8];
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            v[i] = int(values[i]);
+        }
+
+        switch (endpointMode)
+        {
+        case 0: //Luminance, direct
+            setColor(e0, v[0], v[0], v[0], 255);
+            setColor(e1, v[1], v[1], v[1], 255);
+            return true;
+
+        case 1: //Luminance, base+offset
+        {
+            const int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+            const int l1 = std::min(l0 + (v[1] & 0x3F), 255);
+            setColor(e0, l0, l0, l0, 255);
+            setColor(e1, l1, l1, l1, 255);
+            return true;
+        }
+
+        case 4: //Luminance-alpha, direct
+            setColor(e0, v[0], v[0], v[0], v[2]);
+            setColor(e1, v[1], v[1], v[1], v[3]);
+            return true;
+
+        case 5: //Luminance-alpha, base+offset
+            bitTransferSigned(v[1], v[0]);
+            bitTransferSigned(v[3], v[2]);
+            setColor(e0, v[0], v[0], v[0], v[2]);
+            setColor(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+            return true;
+
+        case 6: //RGB, base+scale
+            setColor(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+            setColor(e1, v[0], v[1], v[2], 255);
+            return true;
+
+        case 8:  //RGB, direct
+        case 12: //RGBA, direct
+        {
+            const int a0 = (endpointMode == 12) ? v[6] : 255;
+            const int a1 = (endpointMode == 12) ? v[7] : 255;
+            if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+            {
+                setColor(e0, v[0], v[2], v[4], a0);
+                setColor(e1, v[1], v[3], v[5], a1);
+            }
+            else
+            {
+                // Blue contraction
+                setColor(e0, (v[1] + v[5]) >> 1, (v[3] + v[5]) >> 1, v[5], a1);
+                setColor(e1, (v[0] + v[4]) >> 1, (v[2] + v[4]) >> 1, v[4], a0);
+            }
+            return true;
+        }
+
+        case 9:  //RGB, base+offset
+        case 13: //RGBA, base+offset
+        {
+            bitTransferSigned(v[1], v[0]);
+            bitTransferSigned(v[3], v[2]);
+            bitTransferSigned(v[5], v[4]);
+            if (endpointMode == 13)
+            {
+                bitTransferSigned(v[7], v[6]);
+            }
+
+            const int a0 = (endpointMode == 13) ? v[6]        : 255;
+            const int a1 = (endpointMode == 13) ? v[6] + v[7] : 255;
+            if (v[1] + v[3] + v[5] >= 0)
+            {
+                setColor(e0, v[0], v[2], v[4], a0);
+                setColor(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+            }
+            else
+            {
+                // Blue contraction
+                const int r = v[0] + v[1];
+                const int g = v[2] + v[3];
+                const int b = v[4] + v[5];
+                setColor(e0, (r + b) >> 1, (g + b) >> 1, b, a1);
+                setColor(e1, (v[0] + v[4]) >> 1, (v[2] + v[4]) >> 1, v[4], a0);
+            }
+            return true;
+        }
+
+        case 10: //RGB, base+scale plus two alphas
+            setColor(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+            setColor(e1, v[0], v[1], v[2], v[5]);
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // The partition hash function from the ASTC specification
+    //--------------------------------------------------------------------------------------
+    uint32_t SelectAstcPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitionCount, bool smallBlock) noexcept
+    {
+        if (smallBlock)
+        {
+            x <<= 1;
+            y <<= 1;
+        }
+
+        seed += (partitionCount - 1) * 1024;
+
+        uint32_t rnum = seed;
+        rnum ^= rnum >> 15;
+        rnum -= rnum << 17;
+        rnum += rnum << 7;
+        rnum += rnum << 4;
+        rnum ^= rnum >> 5;
+        rnum += rnum << 16;
+        rnum ^= rnum >> 7;
+        rnum ^= rnum >> 3;
+        rnum ^= rnum << 6;
+        rnum ^= rnum >> 17;
+
+        uint32_t seeds[8];
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            seeds[i] = (rnum >> (i * 4)) & 0xF;
+            seeds[i] *= seeds[i];
+        }
+
+        uint32_t sh1 = 0;
+        uint32_t sh2 = 0;
+        if (seed & 1)
+        {
+            sh1 = (seed & 2) ? 4 : 5;
+            sh2 = (partitionCount == 3) ? 6 : 5;
+        }
+        else
+        {
+            sh1 = (partitionCount == 3) ? 6 : 5;
+            sh2 = (seed & 2) ? 4 : 5;
+        }
+
+        // The z-dependent terms are omitted, only 2D blocks are supported
+        const uint32_t a = ((seeds[0] >> sh1) * x + (seeds[1] >> sh2) * y + (rnum >> 14)) & 0x3F;
+        const uint32_t b = ((seeds[2] >> sh1) * x + (seeds[3] >> sh2) * y + (rnum >> 10)) & 0x3F;
+        const uint32_t c = (partitionCount < 3) ? 0 : (((seeds[4] >> sh1) * x + (seeds[5] >> sh2) * y + (rnum >> 6)) & 0x3F);
+        const uint32_t d = (partitionCount < 4) ? 0 : (((seeds[6] >> sh1) * x + (seeds[7] >> sh2) * y + (rnum >> 2)) & 0x3F);
+
+        if (a >= b && a >= c && a >= d)
+        {
+            return 0;
+        }
+        else if (b >= c && b >= d)
+        {
+            return 1;
+        }
+        else if (c >= d)
+        {
+            return 2;
+        }
+
+        return 3;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decodes ASTC LDR block into blockWidth x blockHeight R8G8B8A8 texels, row-major.
+    // Invalid blocks and HDR blocks are decoded to the error color (magenta)
+    //--------------------------------------------------------------------------------------
+    void DecodeAstcBlock(const uint8_t* block, uint32_t blockWidth, uint32_t blockHeight, bool isSrgb, uint8_t* texels) noexcept
+    {
+        const uint32_t texelCount = blockWidth * blockHeight;
+
+        auto writeConstantColor = [texels, texelCount](uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+        {
+            for (uint32_t i = 0; i < texelCount; ++i)
+            {
+                texels[i * 4 + 0] = static_cast<uint8_t>(r);
+                texels[i * 4 + 1] = static_cast<uint8_t>(g);
+                texels[i * 4 + 2] = static_cast<uint8_t>(b);
+                texels[i * 4 + 3] = static_cast<uint8_t>(a);
+            }
+        };
+
+        auto writeErrorColor = [&writeConstantColor]()
+        {
+            writeConstantColor(255, 0, 255, 255);
+        };
+
+        uint64_t low  = 0;
+        uint64_t high = 0;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            low  |= uint64_t(block[i])     << (i * 8);
+            high |= uint64_t(block[i + 8]) << (i * 8);
+        }
+
+        const uint32_t blockMode = static_cast<uint32_t>(low & 0x7FF);
+        if ((blockMode & 0x1FF) == 0x1FC)
+        {
+            // Void-extent block. HDR void-extent blocks are errors in LDR profile, and so are the blocks with non-1 reserved bits
+            if ((blockMode & 0x200) || (low & 0xC00) != 0xC00)
+            {
+                writeErrorColor();
+                return;
+            }
+
+            // The constant color is stored as 16-bit UNORM values, only the top 8 bits are needed
+            writeConstantColor(uint32_t(high >> 8) & 0xFF, uint32_t(high >> 24) & 0xFF, uint32_t(high >> 40) & 0xFF, uint32_t(high >> 56) & 0xFF);
+            return;
+        }
+
+        uint32_t gridWidth        = 0;
+        uint32_t gridHeight       = 0;
+        bool     isDualPlane      = false;
+        uint32_t weightQuantLevel = 0;
+        if (!DecodeAstcBlockMode(blockMode, &gridWidth, &gridHeight, &isDualPlane, &weightQuantLevel) || gridWidth > blockWidth || gridHeight > blockHeight)
+        {
+            writeErrorColor();
+            return;
+        }
+
+        const uint32_t partitionCount = uint32_t((low >> 11) & 0x3) + 1;
+        if (isDualPlane && partitionCount == 4)
+        {
+            writeErrorColor();
+            return;
+        }
+
+        const uint32_t planeCount     = isDualPlane ? 2 : 1;
+        const uint32_t weightCount    = gridWidth * gridHeight * planeCount;
+        const uint32_t weightBitCount = GetAstcIseBitCount(weightCount, weightQuantLevel);
+
+        // Weights are stored starting from the top bit of the block in reverse order
+        uint8_t weightValues[64];
+        DecodeAstcIntegerSequence(ReverseBits64(high), ReverseBits64(low), 0, weightQuantLevel, weightCount, weightValues);
+
+        AstcBitReader configReader = {low, high, 0, 128};
+
+        uint32_t belowWeightsPosition = 128 - weightBitCount;
+        uint32_t colorDataPosition    = 17;
+        uint32_t partitionIndex       = 0;
+        uint32_t endpointModes[4]     = {};
+        if (partitionCount == 1)
+        {
+            endpointModes[0] = uint32_t(low >> 13) & 0xF;
+        }
+        else
+        {
+            colorDataPosition = 29;
+            partitionIndex    = uint32_t(low >> 13) & 0x3FF;
+
+            uint32_t encodedModes = uint32_t(low >> 23) & 0x3F;
+            if ((encodedModes & 0x3) == 0)
+            {
+                // All partitions share the same endpoint mode
+                for (uint32_t i = 0; i < partitionCount; ++i)
+                {
+                    endpointModes[i] = encodedModes >> 2;
+                }
+            }
+            else
+            {
+                // The rest of the endpoint mode bits are stored right below the weights
+                const uint32_t extraBitCount = 3 * partitionCount - 4;
+                belowWeightsPosition -= extraBitCount;
+
+                configReader.Position = belowWeightsPosition;
+                encodedModes |= configReader.Read(extraBitCount) << 6;
+
+                const uint32_t baseClass = (encodedModes & 0x3) - 1;
+                for (uint32_t i = 0; i < partitionCount; ++i)
+                {
+                    const uint32_t classOffset = (encodedModes >> (2 + i)) & 0x1;
+                    const uint32_t mode        = (encodedModes >> (2 + partitionCount + i * 2)) & 0x3;
+                    endpointModes[i] = ((baseClass + classOffset) << 2) | mode;
+                }
+            }
+        }
+
+        uint32_t secondPlaneComponent = 4;
+        if (isDualPlane)
+        {
+            belowWeightsPosition -= 2;
+
+            configReader.Position = belowWeightsPosition;
+            secondPlaneComponent  = configReader.Read(2);
+        }
+
+        uint32_t colorValueCount = 0;
+        for (uint32_t i = 0; i < partitionCount; ++i)
+        {
+            colorValueCount += ((endpointModes[i] >> 2) + 1) * 2;
+        }
+
+        if (colorValueCount > 18 || belowWeightsPosition < colorDataPosition)
+        {
+            writeErrorColor();
+            return;
+        }
+
+        // Color endpoints use the largest quantization range that fits into the remaining bits
+        const uint32_t colorBitCount   = belowWeightsPosition - colorDataPosition;
+        uint32_t       colorQuantLevel = AstcMaxColorQuantLevel + 1;
+        while (colorQuantLevel > AstcMinColorQuantLevel && GetAstcIseBitCount(colorValueCount, colorQuantLevel - 1) > colorBitCount)
+        {
+            --colorQuantLevel;
+        }
+
+        if (colorQuantLevel == AstcMinColorQuantLevel)
+        {
+            writeErrorColor();
+            return;
+        }
+
+        --colorQuantLevel;
+
+        uint8_t colorValues[18];
+        DecodeAstcIntegerSequence(low, high, colorDataPosition, colorQuantLevel, colorValueCount, colorValues);
+
+        int endpoints[4][2][4];
+        uint32_t colorValueIndex = 0;
+        for (uint32_t i = 0; i < partitionCount; ++i)
+        {
+            uint32_t unquantizedValues[8] = {};
+
+            const uint32_t valueCount = ((endpointModes[i] >> 2) + 1) * 2;
+            for (uint32_t j = 0; j < valueCount; ++j)
+            {
+                unquantizedValues[j] = UnquantizeAstcColor(colorQuantLevel, colorValues[colorValueIndex++]);
+            }
+
+            if (!DecodeAstcEndpoints(endpointModes[i], unquantizedValues, endpoints[i][0], endpoints[i][1]))
+            {
+                writeErrorColor();
+                return;
+            }
+        }
+
+        // Unquantized weights are padded so the infill never reads out of bounds
+        uint32_t gridWeights[2][64 + 16 + 1] = {};
+        for (uint32_t i = 0; i < weightCount; ++i)
+        {
+            gridWeights[i % planeCount][i / planeCount] = UnquantizeAstcWeight(weightQuantLevel, weightValues[i]);
+        }
+
+        const uint32_t ds = (1024 + blockWidth / 2) / (blockWidth - 1);
+        const uint32_t dt = (1024 + blockHeight / 2) / (blockHeight - 1);
+
+        const bool isSmallBlock = texelCount < 31;
+        for (uint32_t t = 0; t < blockHeight; ++t)
+        {
+            for (uint32_t s = 0; s < blockWidth; ++s)
+            {
+                // Bilinear infill of the weight grid
+                const uint32_t gs = (ds * s * (gridWidth - 1) + 32) >> 6;
+                const uint32_t gt = (dt * t * (gridHeight - 1) + 32) >> 6;
+                const uint32_t js = gs >> 4;
+                const uint32_t fs = gs & 0xF;
+                const uint32_t jt = gt >> 4;
+                const uint32_t ft = gt & 0xF;
+
+                const uint32_t v0  = js + jt * gridWidth;
+                const uint32_t w11 = (fs * ft + 8) >> 4;
+                const uint32_t w10 = ft - w11;
+                const uint32_t w01 = fs - w11;
+                const uint32_t w00 = 16 - fs - ft + w11;
+
+                uint32_t texelWeights[2] = {};
+                for (uint32_t p = 0; p < planeCount; ++p)
+                {
+                    const uint32_t* weights = gridWeights[p];
+                    texelWeights[p] = (weights[v0] * w00 + weights[v0 + 1] * w01 + weights[v0 + gridWidth] * w10 + weights[v0 + gridWidth + 1] * w11 + 8) >> 4;
+                }
+
+                const uint32_t partition = (partitionCount > 1) ? SelectAstcPartition(partitionIndex, s, t, partitionCount, isSmallBlock) : 0;
+                const int* e0 = endpoints[partition][0];
+                const int* e1 = endpoints[partition][1];
+
+                uint8_t* texel = texels + (t * blockWidth + s) * 4;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    // Endpoints are expanded to 16 bits, only the top 8 bits of the result are kept
+                    const uint32_t c0 = isSrgb ? ((uint32_t(e0[c]) << 8) | 0x80) : (uint32_t(e0[c]) * 257);
+                    const uint32_t c1 = isSrgb ? ((uint32_t(e1[c]) << 8) | 0x80) : (uint32_t(e1[c]) * 257);
+                    const uint32_t w  = (c == secondPlaneComponent) ? texelWeights[1] : texelWeights[0];
+
+                    texel[c] = static_cast<uint8_t>(((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+                }
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns the block size of LDR ASTC format. Returns false for other formats
+    //--------------------------------------------------------------------------------------
+    bool GetAstcBlockExtent(VkFormat format, uint32_t* outBlockWidth, uint32_t* outBlockHeight, bool* outIsSrgb) noexcept
+    {
+        uint32_t blockWidth  = 0;
+        uint32_t blockHeight = 0;
+        bool     isSrgb      = false;
+        switch (format)
+        {
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:   blockWidth = 4;  blockHeight = 4;  break;
+        case VK_FORMAT_ASTC_5x4_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_5x4_UNORM_BLOCK:   blockWidth = 5;  blockHeight = 4;  break;
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:   blockWidth = 5;  blockHeight = 5;  break;
+        case VK_FORMAT_ASTC_6x5_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_6x5_UNORM_BLOCK:   blockWidth = 6;  blockHeight = 5;  break;
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:   blockWidth = 6;  blockHeight = 6;  break;
+        case VK_FORMAT_ASTC_8x5_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_8x5_UNORM_BLOCK:   blockWidth = 8;  blockHeight = 5;  break;
+        case VK_FORMAT_ASTC_8x6_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_8x6_UNORM_BLOCK:   blockWidth = 8;  blockHeight = 6;  break;
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:   isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:   blockWidth = 8;  blockHeight = 8;  break;
+        case VK_FORMAT_ASTC_10x5_SRGB_BLOCK:  isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_10x5_UNORM_BLOCK:  blockWidth = 10; blockHeight = 5;  break;
+        case VK_FORMAT_ASTC_10x6_SRGB_BLOCK:  isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_10x6_UNORM_BLOCK:  blockWidth = 10; blockHeight = 6;  break;
+        case VK_FORMAT_ASTC_10x8_SRGB_BLOCK:  isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_10x8_UNORM_BLOCK:  blockWidth = 10; blockHeight = 8;  break;
+        case VK_FORMAT_ASTC_10x10_SRGB_BLOCK: isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_10x10_UNORM_BLOCK: blockWidth = 10; blockHeight = 10; break;
+        case VK_FORMAT_ASTC_12x10_SRGB_BLOCK: isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_12x10_UNORM_BLOCK: blockWidth = 12; blockHeight = 10; break;
+        case VK_FORMAT_ASTC_12x12_SRGB_BLOCK: isSrgb = true; [[fallthrough]];
+        case VK_FORMAT_ASTC_12x12_UNORM_BLOCK: blockWidth = 12; blockHeight = 12; break;
+        default:
+            return false;
+        }
+
+        *outBlockWidth  = blockWidth;
+        *outBlockHeight = blockHeight;
+        *outIsSrgb      = isSrgb;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns the format the compressed format gets decompressed to according to the load flags.
+    // Returns VK_FORMAT_UNDEFINED if the format is not to be decompressed
+    //--------------------------------------------------------------------------------------
+    VkFormat GetDecompressedFormat(VkFormat format, unsigned int loadFlags) noexcept
+    {
+        if (loadFlags & DDS_LOADER_DECOMPRESS_ETC2)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return VK_FORMAT_R8G8B8A8_SRGB;
+
+            default:
+                break;
+            }
+        }
+
+        if (loadFlags & DDS_LOADER_DECOMPRESS_ASTC)
+        {
+            uint32_t blockWidth  = 0;
+            uint32_t blockHeight = 0;
+            bool     isSrgb      = false;
+            if (GetAstcBlockExtent(format, &blockWidth, &blockHeight, &isSrgb))
+            {
+                return isSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            }
+        }
+
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decompresses a single ETC2/ASTC subresource into tightly packed texels of the decompressed format
+    //--------------------------------------------------------------------------------------
+    void DecompressSubresource(VkFormat format, const LoadedSubresourceData& subresource, uint8_t* dstData) noexcept
+    {
+        uint32_t blockWidth    = 4;
+        uint32_t blockHeight   = 4;
+        uint32_t bytesPerBlock = 16;
+        bool     isSrgb        = false;
+        if (!GetAstcBlockExtent(format, &blockWidth, &blockHeight, &isSrgb))
+        {
+            bytesPerBlock = (BitsPerPixel(format) == 4) ? 8 : 16;
+        }
+
+        const VkFormat decompressedFormat = GetDecompressedFormat(format, DDS_LOADER_DECOMPRESS_ETC2 | DDS_LOADER_DECOMPRESS_ASTC);
+        const size_t   texelBytes         = BitsPerPixel(decompressedFormat) / 8;
+
+        const size_t width       = subresource.Extent.width;
+        const size_t height      = subresource.Extent.height;
+        const size_t blocksWide  = (width  + blockWidth  - 1) / blockWidth;
+        const size_t blocksHigh  = (height + blockHeight - 1) / blockHeight;
+        const size_t srcRowBytes = blocksWide * bytesPerBlock;
+        const size_t dstRowBytes = width * texelBytes;
+
+        ParallelFor(blocksHigh * subresource.Extent.depth, 16, [&](size_t beginRow, size_t endRow)
+        {
+            uint8_t texels[12 * 12 * 4];
+            for (size_t blockRow = beginRow; blockRow < endRow; ++blockRow)
+            {
+                const size_t slice = blockRow / blocksHigh;
+                const size_t by    = blockRow % blocksHigh;
+
+                const uint8_t* srcRow = subresource.PData + blockRow * srcRowBytes;
+                uint8_t*       dstRow = dstData + (slice * height + by * blockHeight) * dstRowBytes;
+
+                const size_t rowsToCopy = std::min<size_t>(blockHeight, height - by * blockHeight);
+                for (size_t bx = 0; bx < blocksWide; ++bx)
+                {
+                    const uint8_t* srcBlock = srcRow + bx * bytesPerBlock;
+                    switch (format)
+                    {
+                    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+                    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+                        DecodeEtc2ColorBlock(srcBlock, false, texels);
+                        break;
+
+                    case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+                    case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+                        DecodeEtc2ColorBlock(srcBlock, true, texels);
+                        break;
+
+                    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+                    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                        DecodeEtc2ColorBlock(srcBlock + 8, false, texels);
+                        DecodeEtc2AlphaBlock(srcBlock, texels);
+                        break;
+
+                    default:
+                        DecodeAstcBlock(srcBlock, blockWidth, blockHeight, isSrgb, texels);
+                        break;
+                    }
+
+                    const size_t texelsToCopy = std::min<size_t>(blockWidth, width - bx * blockWidth);
+                    for (size_t y = 0; y < rowsToCopy; ++y)
+                    {
+                        memcpy(dstRow + y * dstRowBytes + bx * blockWidth * texelBytes, texels + y * blockWidth * texelBytes, texelsToCopy * texelBytes);
+                    }
+                }
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Converts every subresource to dstFormat with transcodeFunc(subresource, dstData).
+    // The converted data is owned by the storage, and the subresources are updated to point into it
+    //--------------------------------------------------------------------------------------
+    template<typename Func>
+    DDS_LOADER_RESULT TranscodeSubresources(VkFormat dstFormat,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage,
+        const Func& transcodeFunc) noexcept
+    {
+        if (!storage)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        uint64_t totalByteSize = 0;
+        for (const LoadedSubresourceData& subresource : subresources)
+        {
+            size_t numBytes = 0;
+            DDS_LOADER_RESULT surfInfoRes = GetSurfaceInfo(subresource.Extent.width, subresource.Extent.height, dstFormat, subresource.SubresourceSlice.aspectMask, &numBytes, nullptr, nullptr);
+            if (surfInfoRes != DDS_LOADER_SUCCESS)
+            {
+                return surfInfoRes;
+            }
+
+            totalByteSize += uint64_t(numBytes) * subresource.Extent.depth;
+        }
+
+        if (totalByteSize > SIZE_MAX)
+        {
+            return DDS_LOADER_ARITHMETIC_OVERFLOW;
+        }
+
+        std::unique_ptr<uint8_t[]> transcodedData(new (std::nothrow) uint8_t[size_t(totalByteSize)]);
+        if (!transcodedData)
+        {
+            return DDS_LOADER_NO_HOST_MEMORY;
+        }
+
+        uint8_t* dstData = transcodedData.get();
+        for (LoadedSubresourceData& subresource : subresources)
+        {
+            size_t numBytes = 0;
+            GetSurfaceInfo(subresource.Extent.width, subresource.Extent.height, dstFormat, subresource.SubresourceSlice.aspectMask, &numBytes, nullptr, nullptr);
+
+            transcodeFunc(static_cast<const LoadedSubresourceData&>(subresource), dstData);
+
+            subresource.PData        = dstData;
+            subresource.DataByteSize = numBytes * subresource.Extent.depth;
+
+            dstData += subresource.DataByteSize;
+        }
+
+        // The previous storage contents (if any) are not referenced anymore
+        storage->PData        = std::move(transcodedData);
+        storage->DataByteSize = size_t(totalByteSize);
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decompresses ETC2/ASTC subresources on CPU if requested by the load flags.
+    // The format gets replaced with the decompressed one
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT DecompressSubresources(VkFormat& format,
+        unsigned int loadFlags,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage) noexcept
+    {
+        const VkFormat decompressedFormat = GetDecompressedFormat(format, loadFlags);
+        if (decompressedFormat == VK_FORMAT_UNDEFINED)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        const VkFormat srcFormat = format;
+        DDS_LOADER_RESULT result = TranscodeSubresources(decompressedFormat, subresources, storage, [srcFormat](const LoadedSubresourceData& subresource, uint8_t* dstData)
+        {
+            DecompressSubresource(srcFormat, subresource, dstData);
+        });
+
+        if (result == DDS_LOADER_SUCCESS)
+        {
+            format = decompressedFormat;
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    DDS_ALPHA_MODE GetAlphaMode( _In_ const DDS_HEADER* header ) noexcept
+    {
+        if ( header->ddspf.flags & DDS_FOURCC )
+        {
+            if ( MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC )
+            {
+                auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>(reinterpret_cast<const uint8_t*>(header) + sizeof(DDS_HEADER));
+                auto mode = static_cast<DDS_ALPHA_MODE>( d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK );
+                switch( mode )
+                {
+                case DDS_ALPHA_MODE_STRAIGHT:
+                case DDS_ALPHA_MODE_PREMULTIPLIED:
+                case DDS_ALPHA_MODE_OPAQUE:
+                case DDS_ALPHA_MODE_CUSTOM:
+                    return mode;
+
+                case DDS_ALPHA_MODE_UNKNOWN:
+                default:
+                    break;
+                }
+            }
+            else if ( ( MAKEFOURCC( 'D', 'X', 'T', '2' ) == header->ddspf.fourCC )
+                      || ( MAKEFOURCC( 'D', 'X', 'T', '4' ) == header->ddspf.fourCC ) )
+            {
+                return DDS_ALPHA_MODE_PREMULTIPLIED;
+            }
+        }
+
+        return DDS_ALPHA_MODE_UNKNOWN;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // BC1/BC3/BC4/BC5 block compression.
+    // A range fit encoder: the endpoints are taken from the inset bounding box of the block,
+    // and each texel gets the index of the closest palette entry
+    //--------------------------------------------------------------------------------------
+    constexpr size_t BcBlockTexelCount = 16;
+
+    //--------------------------------------------------------------------------------------
+    // Loads 4x4 block of R8G8B8A8 texels, replicating the edge texels for partial blocks.
+    // Missing channels are set to 0, B8G8R8A8 texels are swizzled to R8G8B8A8
+    //--------------------------------------------------------------------------------------
+    void LoadBlockTexels(const uint8_t* srcData, size_t width, size_t height, size_t texelBytes, bool isBgra, size_t bx, size_t by, uint8_t (*outTexels)[4]) noexcept
+    {
+        for (size_t y = 0; y < 4; ++y)
+        {
+            const size_t   srcY   = std::min(by * 4 + y, height - 1);
+            const uint8_t* srcRow = srcData + srcY * width * texelBytes;
+            for (size_t x = 0; x < 4; ++x)
+            {
+                const size_t   srcX     = std::min(bx * 4 + x, width - 1);
+                const uint8_t* srcTexel = srcRow + srcX * texelBytes;
+
+                uint8_t* texel = outTexels[y * 4 + x];
+                texel[0] = srcTexel[0];
+                texel[1] = (texelBytes > 1) ? srcTexel[1] : 0;
+                texel[2] = (texelBytes > 2) ? srcTexel[2] : 0;
+                texel[3] = (texelBytes > 3) ? srcTexel[3] : 0;
+                if (isBgra)
+                {
+                    std::swap(texel[0], texel[2]);
+                }
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Encodes 16 values of the channel into BC4 (or BC3 alpha) block
+    //--------------------------------------------------------------------------------------
+    void EncodeBc4Block(const uint8_t (*texels)[4], uint32_t channel, uint8_t* block) noexcept
+    {
+        int minValue = 255;
+        int maxValue = 0;
+        for (size_t i = 0; i < BcBlockTexelCount; ++i)
+        {
+            minValue = std::min<int>(minValue, texels[i][channel]);
+            maxValue = std::max<int>(maxValue, texels[i][channel]);
+        }
+
+        // The first endpoint is larger, which selects the 8-value palette
+        block[0] = static_cast<uint8_t>(maxValue);
+        block[1] = static_cast<uint8_t>(minValue);
+
+        uint64_t indexBits = 0;
+        const int range = maxValue - minValue;
+        if (range != 0)
+        {
+            for (size_t i = 0; i < BcBlockTexelCount; ++i)
+            {
+                // Palette entries from min to max have indices 1, 7, 6, 5, 4, 3, 2, 0
+                const int step = ((texels[i][channel] - minValue) * 7 + range / 2) / range;
+
+                uint64_t index = 8 - step;
+                if (step == 0)
+                {
+                    index = 1;
+                }
+                else if (step == 7)
+                {
+                    index = 0;
+                }
+
+                indexBits |= index << (i * 3);
+            }
+        }
+
+        for (size_t i = 0; i < 6; ++i)
+        {
+            block[2 + i] = static_cast<uint8_t>(indexBits >> (i * 8));
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Encodes the RGB channels of 16 texels into BC1 block (in four-color mode)
+    //--------------------------------------------------------------------------------------
+    void EncodeBc1Block(const uint8_t (*texels)[4], uint8_t* block) noexcept
+    {
+        int minColor[3] = {255, 255, 255};
+        int maxColor[3] = {0, 0, 0};
+        int sumColor[3] = {0, 0, 0};
+        for (size_t i = 0; i < BcBlockTexelCount; ++i)
+        {
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                minColor[c]  = std::min<int>(minColor[c], texels[i][c]);
+                maxColor[c]  = std::max<int>(maxColor[c], texels[i][c]);
+                sumColor[c] += texels[i][c];
+            }
+        }
+
+        // Choose the diagonal of the bounding box the texels lie along, relative to the channel with the largest range
+        uint32_t mainChannel = 0;
+        for (uint32_t c = 1; c < 3; ++c)
+        {
+            if (maxColor[c] - minColor[c] > maxColor[mainChannel] - minColor[mainChannel])
+            {
+                mainChannel = c;
+            }
+        }
+
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            if (c == mainChannel)
+            {
+                continue;
+            }
+
+            int covariance = 0;
+            for (size_t i = 0; i < BcBlockTexelCount; ++i)
+            {
+                covariance += (texels[i][mainChannel] * 16 - sumColor[mainChannel]) * (texels[i][c] * 16 - sumColor[c]) / 256;
+            }
+
+            if (covariance < 0)
+            {
+                std::swap(minColor[c], maxColor[c]);
+            }
+        }
+
+        // Inset the bounding box by 1/16 of its size, since the endpoints are rarely hit exactly
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            const int inset = (maxColor[c] - minColor[c]) / 16;
+            maxColor[c] -= inset;
+            minColor[c] += inset;
+        }
+
+        auto packColor = [](const int* color) -> uint16_t
+        {
+            const int r = (color[0] * 31 + 127) / 255;
+            const int g = (color[1] * 63 + 127) / 255;
+            const int b = (color[2] * 31 + 127) / 255;
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        };
+
+        uint16_t endpoints[2] = {packColor(maxColor), packColor(minColor)};
+        if (endpoints[0] < endpoints[1])
+        {
+            // The first endpoint must be larger to select the four-color mode
+            std::swap(endpoints[0], endpoints[1]);
+        }
+
+        uint32_t indexBits = 0;
+        if (endpoints[0] != endpoints[1])
+        {
+            int palette[4][3];
+            for (uint32_t e = 0; e < 2; ++e)
+            {
+                const int r = (endpoints[e] >> 11) & 0x1F;
+                const int g = (endpoints[e] >> 5)  & 0x3F;
+                const int b = endpoints[e] & 0x1F;
+                palette[e][0] = (r << 3) | (r >> 2);
+                palette[e][1] = (g << 2) | (g >> 4);
+                palette[e][2] = (b << 3) | (b >> 2);
+            }
+
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (size_t i = 0; i < BcBlockTexelCount; ++i)
+            {
+                uint32_t bestIndex    = 0;
+                int      bestDistance = INT32_MAX;
+                for (uint32_t p = 0; p < 4; ++p)
+                {
+                    const int dr = texels[i][0] - palette[p][0];
+                    const int dg = texels[i][1] - palette[p][1];
+                    const int db = texels[i][2] - palette[p][2];
+
+                    const int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance)
+                    {
+                        bestIndex    = p;
+                        bestDistance = distance;
+                    }
+                }
+
+                indexBits |= bestIndex << (i * 2);
+            }
+        }
+
+        block[0] = static_cast<uint8_t>(endpoints[0]);
+        block[1] = static_cast<uint8_t>(endpoints[0] >> 8);
+        block[2] = static_cast<uint8_t>(endpoints[1]);
+        block[3] = static_cast<uint8_t>(endpoints[1] >> 8);
+        block[4] = static_cast<uint8_t>(indexBits);
+        block[5] = static_cast<uint8_t>(indexBits >> 8);
+        block[6] = static_cast<uint8_t>(indexBits >> 16);
+        block[7] = static_cast<uint8_t>(indexBits >> 24);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Opaque alpha detection
+    //--------------------------------------------------------------------------------------
+    inline bool IsOpaqueBc2AlphaBlock(const uint8_t* block) noexcept
+    {
+        // Explicit 4-bit alpha values, all of them must be 0xF
+        uint64_t alphaBits = 0;
+        memcpy(&alphaBits, block, sizeof(uint64_t));
+        return alphaBits == UINT64_MAX;
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline bool IsOpaqueBc3AlphaBlock(const uint8_t* block) noexcept
+    {
+        const uint32_t a0 = block[0];
+        const uint32_t a1 = block[1];
+        if (a0 == 255 && a1 == 255)
+        {
+            // The most common case, every palette entry is 255
+            return true;
+        }
+
+        // Find which palette entries are 255 and check that the indices only reference them
+        uint32_t opaqueIndexMask = (a0 == 255 ? 0x1 : 0) | (a1 == 255 ? 0x2 : 0);
+        if (a0 <= a1)
+        {
+            opaqueIndexMask |= 0x80;
+        }
+
+        if (opaqueIndexMask == 0)
+        {
+            return false;
+        }
+
+        uint64_t indexBits = 0;
+        for (size_t i = 0; i < 6; ++i)
+        {
+            indexBits |= uint64_t(block[2 + i]) << (i * 8);
+        }
+
+        for (size_t i = 0; i < BcBlockTexelCount; ++i)
+        {
+            if (!(opaqueIndexMask & (1u << ((indexBits >> (i * 3)) & 0x7))))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns true if predicate(element) holds for every elementBytes-sized element of every subresource
+    //--------------------------------------------------------------------------------------
+    template<typename Predicate>
+    bool AllSubresourceElementsMatch(const std::vector<LoadedSubresourceData>& subresources, size_t elementBytes, const Predicate& predicate)
+    {
+        std::atomic<bool> allMatch(true);
+        for (const LoadedSubresourceData& subresource : subresources)
+        {
+            const size_t elementCount = subresource.DataByteSize / elementBytes;
+            ParallelFor(elementCount, 64 * 1024, [&](size_t begin, size_t end)
+            {
+                // Check the other threads' results once in a while to stop early
+                constexpr size_t checkInterval = 4096;
+                for (size_t chunkBegin = begin; chunkBegin < end && allMatch.load(std::memory_order_relaxed); chunkBegin += checkInterval)
+                {
+                    const size_t chunkEnd = std::min(end, chunkBegin + checkInterval);
+                    for (size_t i = chunkBegin; i < chunkEnd; ++i)
+                    {
+                        if (!predicate(subresource.PData + i * elementBytes))
+                        {
+                            allMatch.store(false, std::memory_order_relaxed);
+                            return;
+                        }
+                    }
+                }
+            });
+
+            if (!allMatch.load())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns true if every texel of every subresource has alpha of 1.
+    // Only BC2, BC3, 8-bit RGBA and 32-bit float RGBA formats are checked, returns false for other formats
+    //--------------------------------------------------------------------------------------
+    bool AreSubresourcesOpaque(VkFormat format, const std::vector<LoadedSubresourceData>& subresources)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+            return AllSubresourceElementsMatch(subresources, 16, IsOpaqueBc2AlphaBlock);
+
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            return AllSubresourceElementsMatch(subresources, 16, IsOpaqueBc3AlphaBlock);
+
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return AllSubresourceElementsMatch(subresources, 4, [](const uint8_t* texel) { return texel[3] == 255; });
+
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return AllSubresourceElementsMatch(subresources, 16, [](const uint8_t* texel)
+            {
+                float alpha = 0.0f;
+                memcpy(&alpha, texel + 3 * sizeof(float), sizeof(float));
+                return alpha == 1.0f;
+            });
+
+        default:
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Converts the color half of BC2/BC3 block to a BC1 block that decodes to the same colors.
+    // BC2/BC3 color blocks are always decoded in four-color mode, BC1 blocks are only if the first endpoint is larger
+    //--------------------------------------------------------------------------------------
+    void ConvertColorBlockToBc1(const uint8_t* colorBlock, uint8_t* dstBlock) noexcept
+    {
+        const uint16_t c0 = uint16_t(colorBlock[0] | (colorBlock[1] << 8));
+        const uint16_t c1 = uint16_t(colorBlock[2] | (colorBlock[3] << 8));
+        if (c0 > c1)
+        {
+            memcpy(dstBlock, colorBlock, 8);
+        }
+        else if (c0 < c1)
+        {
+            // Swapping the endpoints swaps palette entries 0 <-> 1 and 2 <-> 3
+            dstBlock[0] = colorBlock[2];
+            dstBlock[1] = colorBlock[3];
+            dstBlock[2] = colorBlock[0];
+            dstBlock[3] = colorBlock[1];
+            for (size_t i = 4; i < 8; ++i)
+            {
+                dstBlock[i] = colorBlock[i] ^ 0x55;
+            }
+        }
+        else
+        {
+            // All palette entries are the same color, index 3 would be transparent black in BC1
+            memcpy(dstBlock, colorBlock, 4);
+            memset(dstBlock + 4, 0, 4);
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Detects fully opaque subresources if requested by the load flags.
+    // Opaque BC2/BC3 subresources are transcoded to BC1, the alpha mode is set to opaque
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT DropOpaqueAlpha(VkFormat& format,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE& alphaMode,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage) noexcept
+    {
+        if (!(loadFlags & DDS_LOADER_DROP_OPAQUE_ALPHA))
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        VkFormat bc1Format = VK_FORMAT_UNDEFINED;
+        switch (format)
+        {
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+            bc1Format = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            break;
+
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            bc1Format = VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+            break;
+
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            // Only worth scanning if the result affects the compression
+            if ((loadFlags & DDS_LOADER_COMPRESS_BC) && AreSubresourcesOpaque(format, subresources))
+            {
+                alphaMode = DDS_ALPHA_MODE_OPAQUE;
+            }
+            return DDS_LOADER_SUCCESS;
+
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            // Only worth scanning if the result affects the float conversion
+            if ((loadFlags & DDS_LOADER_CONVERT_FLOAT) && AreSubresourcesOpaque(format, subresources))
+            {
+                alphaMode = DDS_ALPHA_MODE_OPAQUE;
+            }
+            return DDS_LOADER_SUCCESS;
+
+        default:
+            return DDS_LOADER_SUCCESS;
+        }
+
+        if (!AreSubresourcesOpaque(format, subresources))
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        DDS_LOADER_RESULT result = TranscodeSubresources(bc1Format, subresources, storage, [](const LoadedSubresourceData& subresource, uint8_t* dstData)
+        {
+            const size_t blockCount = subresource.DataByteSize / 16;
+            ParallelFor(blockCount, 64 * 1024, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ConvertColorBlockToBc1(subresource.PData + i * 16 + 8, dstData + i * 8);
+                }
+            });
+        });
+
+        if (result == DDS_LOADER_SUCCESS)
+        {
+            format    = bc1Format;
+            alphaMode = DDS_ALPHA_MODE_OPAQUE;
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // 32-bit float to 16-bit and packed 11/10-bit float conversion
+    //--------------------------------------------------------------------------------------
+
+    //--------------------------------------------------------------------------------------
+    // Converts the absolute value of the float to a float with 5-bit exponent and mantissaBits-bit mantissa,
+    // rounding to nearest even. Covers both halves (10-bit mantissa) and unsigned 11/10-bit floats
+    //--------------------------------------------------------------------------------------
+    uint32_t FloatToSmallFloatMagnitude(uint32_t floatBits, uint32_t mantissaBits) noexcept
+    {
+        const uint32_t infinity = 0x1Fu << mantissaBits;
+
+        floatBits &= 0x7FFFFFFF;
+        if (floatBits >= 0x7F800000)
+        {
+            // Infinity stays infinity, NaN stays (quiet) NaN
+            return (floatBits == 0x7F800000) ? infinity : (infinity | (1u << (mantissaBits - 1)));
+        }
+
+        const int exponent = int(floatBits >> 23) - 127 + 15;
+        uint32_t  mantissa = floatBits & 0x7FFFFF;
+        uint32_t  shift    = 23 - mantissaBits;
+        if (exponent >= 31)
+        {
+            return infinity;
+        }
+
+        uint32_t result = 0;
+        if (exponent <= 0)
+        {
+            // Denormal, the implicit leading bit becomes explicit
+            shift += uint32_t(1 - exponent);
+            if (shift > 24)
+            {
+                return 0;
+            }
+
+            mantissa |= 0x800000;
+            result = mantissa >> shift;
+        }
+        else
+        {
+            result = (uint32_t(exponent) << mantissaBits) | (mantissa >> shift);
+        }
+
+        // The carry from rounding correctly propagates into the exponent (up to infinity)
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway   = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1)))
+        {
+            ++result;
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    inline uint16_t FloatToHalf(float value) noexcept
+    {
+        uint32_t floatBits = 0;
+        memcpy(&floatBits, &value, sizeof(float));
+        return static_cast<uint16_t>(((floatBits >> 16) & 0x8000) | FloatToSmallFloatMagnitude(floatBits, 10));
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Converts 4 floats to 4 halves, using hardware conversion if the compiler targets it
+    //--------------------------------------------------------------------------------------
+    inline void ConvertFloat4ToHalf4(const float* src, uint16_t* dst) noexcept
+    {
+#if defined(DDS_LOADER_F16C)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_cvtps_ph(_mm_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(DDS_LOADER_NEON_FP16)
+        vst1_u16(dst, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src))));
+#else
+        for (size_t i = 0; i < 4; ++i)
+        {
+            dst[i] = FloatToHalf(src[i]);
+        }
+#endif
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Packs non-negative RGB floats into B10G11R11_UFLOAT_PACK32
+    //--------------------------------------------------------------------------------------
+    inline uint32_t PackB10G11R11(const float* rgb) noexcept
+    {
+        uint32_t floatBits[3];
+        memcpy(floatBits, rgb, sizeof(floatBits));
+
+        // Negative values are clamped to 0, the callers only pass non-negative data
+        uint32_t packed = 0;
+        packed |= ((floatBits[0] & 0x80000000) ? 0 : FloatToSmallFloatMagnitude(floatBits[0], 6));
+        packed |= ((floatBits[1] & 0x80000000) ? 0 : FloatToSmallFloatMagnitude(floatBits[1], 6)) << 11;
+        packed |= ((floatBits[2] & 0x80000000) ? 0 : FloatToSmallFloatMagnitude(floatBits[2], 5)) << 22;
+        return packed;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns the format 32-bit float image gets converted to according to the load flags.
+    // Returns VK_FORMAT_UNDEFINED if the image is not to be converted
+    //--------------------------------------------------------------------------------------
+    VkFormat GetFloatConvertedFormat(VkFormat format,
+        VkImageCreateFlags imageCreateFlags,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE alphaMode,
+        const std::vector<LoadedSubresourceData>& subresources)
+    {
+        // Views of mutable format images may reinterpret the data, it must stay as is
+        if (!(loadFlags & DDS_LOADER_CONVERT_FLOAT) || (imageCreateFlags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT))
+        {
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        size_t texelBytes = 0;
+        switch (format)
+        {
+        case VK_FORMAT_R32G32B32_SFLOAT:
+            texelBytes = 3 * sizeof(float);
+            break;
+
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            if (alphaMode != DDS_ALPHA_MODE_OPAQUE)
+            {
+                return VK_FORMAT_R16G16B16A16_SFLOAT;
+            }
+
+            texelBytes = 4 * sizeof(float);
+            break;
+
+        default:
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        // B10G11R11 can only store non-negative values. NaNs fail the comparison, so they are preserved in R16G16B16A16
+        const bool isNonNegative = AllSubresourceElementsMatch(subresources, texelBytes, [](const uint8_t* texel)
+        {
+            float rgb[3];
+            memcpy(rgb, texel, sizeof(rgb));
+            return rgb[0] >= 0.0f && rgb[1] >= 0.0f && rgb[2] >= 0.0f;
+        });
+
+        return isNonNegative ? VK_FORMAT_B10G11R11_UFLOAT_PACK32 : VK_FORMAT_R16G16B16A16_SFLOAT;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Converts R32G32B32_SFLOAT and R32G32B32A32_SFLOAT images to smaller float formats if requested by the load flags.
+    // The format gets replaced with the converted one
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT ConvertFloatSubresources(VkFormat& format,
+        VkImageCreateFlags imageCreateFlags,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE alphaMode,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage)
+    {
+        const VkFormat convertedFormat = GetFloatConvertedFormat(format, imageCreateFlags, loadFlags, alphaMode, subresources);
+        if (convertedFormat == VK_FORMAT_UNDEFINED)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        const uint32_t srcChannelCount = (format == VK_FORMAT_R32G32B32_SFLOAT) ? 3 : 4;
+        DDS_LOADER_RESULT result = TranscodeSubresources(convertedFormat, subresources, storage, [srcChannelCount, convertedFormat](const LoadedSubresourceData& subresource, uint8_t* dstData)
+        {
+            const float*   srcTexels  = reinterpret_cast<const float*>(subresource.PData);
+            const size_t   texelCount = subresource.DataByteSize / (srcChannelCount * sizeof(float));
+            ParallelFor(texelCount, 64 * 1024, [&](size_t begin, size_t end)
+            {
+                if (convertedFormat == VK_FORMAT_B10G11R11_UFLOAT_PACK32)
+                {
+                    uint32_t* dstTexels = reinterpret_cast<uint32_t*>(dstData);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        dstTexels[i] = PackB10G11R11(srcTexels + i * srcChannelCount);
+                    }
+                }
+                else
+                {
+                    uint16_t* dstTexels = reinterpret_cast<uint16_t*>(dstData);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        // RGB images get the alpha of 1
+                        float texel[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+                        memcpy(texel, srcTexels + i * srcChannelCount, srcChannelCount * sizeof(float));
+                        ConvertFloat4ToHalf4(texel, dstTexels + i * 4);
+                    }
+                }
+            });
+        });
+
+        if (result == DDS_LOADER_SUCCESS)
+        {
+            format = convertedFormat;
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Constant color detection
+    //--------------------------------------------------------------------------------------
+
+    //--------------------------------------------------------------------------------------
+    // Returns true if BC1-BC5 block decodes to a single color, i.e. all its indices are the same
+    //--------------------------------------------------------------------------------------
+    bool IsConstantBcBlock(VkFormat format, const uint8_t* block) noexcept
+    {
+        auto isUniformColorBlock = [](const uint8_t* colorBlock)
+        {
+            const uint32_t indexBits = uint32_t(colorBlock[4]) | (uint32_t(colorBlock[5]) << 8) | (uint32_t(colorBlock[6]) << 16) | (uint32_t(colorBlock[7]) << 24);
+            return indexBits == (indexBits & 0x3) * 0x55555555u;
+        };
+
+        auto isUniformAlphaBlock = [](const uint8_t* alphaBlock)
+        {
+            uint64_t indexBits = 0;
+            for (size_t i = 0; i < 6; ++i)
+            {
+                indexBits |= uint64_t(alphaBlock[2 + i]) << (i * 8);
+            }
+
+            return indexBits == (indexBits & 0x7) * 0x249249249249ull;
+        };
+
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            return isUniformColorBlock(block);
+
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        {
+            uint64_t alphaBits = 0;
+            memcpy(&alphaBits, block, sizeof(uint64_t));
+            return alphaBits == (alphaBits & 0xF) * 0x1111111111111111ull && isUniformColorBlock(block + 8);
+        }
+
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            return isUniformAlphaBlock(block) && isUniformColorBlock(block + 8);
+
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return isUniformAlphaBlock(block);
+
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+            return isUniformAlphaBlock(block) && isUniformAlphaBlock(block + 8);
+
+        default:
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns the size of the smallest addressable element of single-plane format: a texel for uncompressed formats,
+    // a block for block-compressed formats, a texel pair for packed formats. Returns 0 for multi-planar formats
+    //--------------------------------------------------------------------------------------
+    size_t GetElementSize(VkFormat format) noexcept
+    {
+        size_t numBytes = 0;
+        if (GetVkFormatPlaneCount(format) != 1 || GetSurfaceInfo(1, 1, format, VK_IMAGE_ASPECT_COLOR_BIT, &numBytes, nullptr, nullptr) != DDS_LOADER_SUCCESS)
+        {
+            return 0;
+        }
+
+        return numBytes;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Detects the images where every texel of every subresource is the same if requested by the load flags.
+    // The subresources of such images are replaced with a single 1x1 mip per array layer
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CollapseConstantSubresources(VkFormat format,
+        unsigned int loadFlags,
+        bool& isCollapsed,
+        std::vector<LoadedSubresourceData>& subresources)
+    {
+        isCollapsed = false;
+        if (!(loadFlags & DDS_LOADER_COLLAPSE_CONSTANT) || subresources.empty())
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        const size_t elementBytes = GetElementSize(format);
+        if (elementBytes == 0)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        // Elements larger than a texel are blocks, only BC1-BC5 blocks are checked
+        const uint8_t* firstElement = subresources.front().PData;
+        if (elementBytes * 8 != BitsPerPixel(format) && !IsConstantBcBlock(format, firstElement))
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        // Identical blocks that decode to a single color each are all the same color
+        const bool isConstant = AllSubresourceElementsMatch(subresources, elementBytes, [firstElement, elementBytes](const uint8_t* element)
+        {
+            return memcmp(element, firstElement, elementBytes) == 0;
+        });
+
+        if (!isConstant)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        // Keep the first loaded mip of each array layer, all of them point to the same element
+        const uint32_t firstMipLevel = subresources.front().SubresourceSlice.mipLevel;
+        subresources.erase(std::remove_if(subresources.begin(), subresources.end(), [firstMipLevel](const LoadedSubresourceData& subresource)
+        {
+            return subresource.SubresourceSlice.mipLevel != firstMipLevel;
+        }), subresources.end());
+
+        for (LoadedSubresourceData& subresource : subresources)
+        {
+            subresource.PData                     = firstElement;
+            subresource.DataByteSize              = elementBytes;
+            subresource.SubresourceSlice.mipLevel = 0;
+            subresource.Extent.width              = 1;
+            subresource.Extent.height             = 1;
+            subresource.Extent.depth              = 1;
+        }
+
+        isCollapsed = true;
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Returns the BC format the uncompressed format gets compressed to according to the load flags.
+    // Returns VK_FORMAT_UNDEFINED if the image is not to be compressed
+    //--------------------------------------------------------------------------------------
+    VkFormat GetBcCompressedFormat(VkFormat format,
+        VkImageType imgType,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags imageCreateFlags,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE alphaMode) noexcept
+    {
+        // Views of mutable format images may reinterpret the data, it must stay as is
+        if (!(loadFlags & DDS_LOADER_COMPRESS_BC) || (imageCreateFlags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT))
+        {
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        // Block-compressed images can't be rendered to or used as storage images
+        constexpr VkImageUsageFlags bcCompatibleUsage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        if (imgType != VK_IMAGE_TYPE_2D || (usageFlags & ~bcCompatibleUsage) != 0)
+        {
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        // Images with alpha declared as opaque don't need the alpha block
+        const bool isOpaque = (alphaMode == DDS_ALPHA_MODE_OPAQUE);
+
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+            return isOpaque ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return isOpaque ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC3_SRGB_BLOCK;
+
+        case VK_FORMAT_R8_UNORM:
+            return VK_FORMAT_BC4_UNORM_BLOCK;
+
+        case VK_FORMAT_R8G8_UNORM:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+
+        default:
+            return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Compresses a single uncompressed 2D subresource into BC blocks of compressedFormat
+    //--------------------------------------------------------------------------------------
+    void CompressSubresource(VkFormat format, VkFormat compressedFormat, const LoadedSubresourceData& subresource, uint8_t* dstData) noexcept
+    {
+        const size_t texelBytes    = BitsPerPixel(format) / 8;
+        const size_t bytesPerBlock = BitsPerPixel(compressedFormat) * BcBlockTexelCount / 8;
+        const bool   isBgra        = (format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB);
+
+        const size_t width      = subresource.Extent.width;
+        const size_t height     = subresource.Extent.height;
+        const size_t blocksWide = (width  + 3) / 4;
+        const size_t blocksHigh = (height + 3) / 4;
+
+        ParallelFor(blocksHigh, 16, [&](size_t beginRow, size_t endRow)
+        {
+            uint8_t texels[BcBlockTexelCount][4];
+            for (size_t by = beginRow; by < endRow; ++by)
+            {
+                uint8_t* dstBlock = dstData + by * blocksWide * bytesPerBlock;
+                for (size_t bx = 0; bx < blocksWide; ++bx)
+                {
+                    LoadBlockTexels(subresource.PData, width, height, texelBytes, isBgra, bx, by, texels);
+                    switch (compressedFormat)
+                    {
+                    case VK_FORMAT_BC3_UNORM_BLOCK:
+                    case VK_FORMAT_BC3_SRGB_BLOCK:
+                        EncodeBc4Block(texels, 3, dstBlock);
+                        EncodeBc1Block(texels, dstBlock + 8);
+                        break;
+
+                    case VK_FORMAT_BC4_UNORM_BLOCK:
+                        EncodeBc4Block(texels, 0, dstBlock);
+                        break;
+
+                    case VK_FORMAT_BC5_UNORM_BLOCK:
+                        EncodeBc4Block(texels, 0, dstBlock);
+                        EncodeBc4Block(texels, 1, dstBlock + 8);
+                        break;
+
+                    default:
+                        EncodeBc1Block(texels, dstBlock);
+                        break;
+                    }
+
+                    dstBlock += bytesPerBlock;
+                }
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Compresses uncompressed 8-bit subresources to BC formats on CPU if requested by the load flags.
+    // The format gets replaced with the compressed one
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CompressSubresources(VkFormat& format,
+        VkImageType imgType,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags imageCreateFlags,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE alphaMode,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage) noexcept
+    {
+        const VkFormat compressedFormat = GetBcCompressedFormat(format, imgType, usageFlags, imageCreateFlags, loadFlags, alphaMode);
+        if (compressedFormat == VK_FORMAT_UNDEFINED)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        const VkFormat srcFormat = format;
+        DDS_LOADER_RESULT result = TranscodeSubresources(compressedFormat, subresources, storage, [srcFormat, compressedFormat](const LoadedSubresourceData& subresource, uint8_t* dstData)
+        {
+            CompressSubresource(srcFormat, compressedFormat, subresource, dstData);
+        });
+
+        if (result == DDS_LOADER_SUCCESS)
+        {
+            format = compressedFormat;
+        }
+
+        return result;
+    }
+
+#ifdef VK_KHR_image_format_list
+    //--------------------------------------------------------------------------------------
+    // The formats a typeless image can be viewed as, grouped by the DXGI typeless family
+    //--------------------------------------------------------------------------------------
+    constexpr uint32_t MaxViewFormatFamilySize = 5;
+    static_assert(MaxViewFormatFamilySize <= sizeof(ImageFormatList::ViewFormats) / sizeof(VkFormat), "The view format family doesn't fit into ImageFormatList");
+
+    constexpr VkFormat ViewFormatFamilies[][MaxViewFormatFamilySize] =
+    {
+        {VK_FORMAT_R32G32B32A32_SFLOAT,      VK_FORMAT_R32G32B32A32_UINT,       VK_FORMAT_R32G32B32A32_SINT},
+        {VK_FORMAT_R32G32B32_SFLOAT,         VK_FORMAT_R32G32B32_UINT,          VK_FORMAT_R32G32B32_SINT},
+        {VK_FORMAT_R16G16B16A16_SFLOAT,      VK_FORMAT_R16G16B16A16_UNORM,      VK_FORMAT_R16G16B16A16_UINT, VK_FORMAT_R16G16B16A16_SNORM, VK_FORMAT_R16G16B16A16_SINT},
+        {VK_FORMAT_R32G32_SFLOAT,            VK_FORMAT_R32G32_UINT,             VK_FORMAT_R32G32_SINT},
+        {VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_FORMAT_A2B10G10R10_UINT_PACK32},
+        {VK_FORMAT_R8G8B8A8_UNORM,           VK_FORMAT_R8G8B8A8_SRGB,           VK_FORMAT_R8G8B8A8_UINT,     VK_FORMAT_R8G8B8A8_SNORM,     VK_FORMAT_R8G8B8A8_SINT},
+        {VK_FORMAT_R16G16_SFLOAT,            VK_FORMAT_R16G16_UNORM,            VK_FORMAT_R16G16_UINT,       VK_FORMAT_R16G16_SNORM,       VK_FORMAT_R16G16_SINT},
+        {VK_FORMAT_R32_SFLOAT,               VK_FORMAT_R32_UINT,                VK_FORMAT_R32_SINT},
+        {VK_FORMAT_R8G8_UNORM,               VK_FORMAT_R8G8_UINT,               VK_FORMAT_R8G8_SNORM,        VK_FORMAT_R8G8_SINT},
+        {VK_FORMAT_R16_SFLOAT,               VK_FORMAT_R16_UNORM,               VK_FORMAT_R16_UINT,          VK_FORMAT_R16_SNORM,          VK_FORMAT_R16_SINT},
+        {VK_FORMAT_R8_UNORM,                 VK_FORMAT_R8_UINT,                 VK_FORMAT_R8_SNORM,          VK_FORMAT_R8_SINT},
+        {VK_FORMAT_B8G8R8A8_UNORM,           VK_FORMAT_B8G8R8A8_SRGB},
+        {VK_FORMAT_BC1_RGBA_UNORM_BLOCK,     VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+        {VK_FORMAT_BC1_RGB_UNORM_BLOCK,      VK_FORMAT_BC1_RGB_SRGB_BLOCK},
+        {VK_FORMAT_BC2_UNORM_BLOCK,          VK_FORMAT_BC2_SRGB_BLOCK},
+        {VK_FORMAT_BC3_UNORM_BLOCK,          VK_FORMAT_BC3_SRGB_BLOCK},
+        {VK_FORMAT_BC4_UNORM_BLOCK,          VK_FORMAT_BC4_SNORM_BLOCK},
+        {VK_FORMAT_BC5_UNORM_BLOCK,          VK_FORMAT_BC5_SNORM_BLOCK},
+        {VK_FORMAT_BC6H_UFLOAT_BLOCK,        VK_FORMAT_BC6H_SFLOAT_BLOCK},
+        {VK_FORMAT_BC7_UNORM_BLOCK,          VK_FORMAT_BC7_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_4x4_UNORM_BLOCK,     VK_FORMAT_ASTC_4x4_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_5x4_UNORM_BLOCK,     VK_FORMAT_ASTC_5x4_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_5x5_UNORM_BLOCK,     VK_FORMAT_ASTC_5x5_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_6x5_UNORM_BLOCK,     VK_FORMAT_ASTC_6x5_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_6x6_UNORM_BLOCK,     VK_FORMAT_ASTC_6x6_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_8x5_UNORM_BLOCK,     VK_FORMAT_ASTC_8x5_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_8x6_UNORM_BLOCK,     VK_FORMAT_ASTC_8x6_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_8x8_UNORM_BLOCK,     VK_FORMAT_ASTC_8x8_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_10x5_UNORM_BLOCK,    VK_FORMAT_ASTC_10x5_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_10x6_UNORM_BLOCK,    VK_FORMAT_ASTC_10x6_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_10x8_UNORM_BLOCK,    VK_FORMAT_ASTC_10x8_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_10x10_UNORM_BLOCK,   VK_FORMAT_ASTC_10x10_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_12x10_UNORM_BLOCK,   VK_FORMAT_ASTC_12x10_SRGB_BLOCK},
+        {VK_FORMAT_ASTC_12x12_UNORM_BLOCK,   VK_FORMAT_ASTC_12x12_SRGB_BLOCK},
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Writes the view formats of the image created from typeless data. Returns the number of formats written,
+    // or 0 if the format doesn't belong to any typeless family
+    //--------------------------------------------------------------------------------------
+    uint32_t GetTypelessViewFormats(VkFormat format, VkFormat* outViewFormats) noexcept
+    {
+        for (const auto& family : ViewFormatFamilies)
+        {
+            if (std::find(std::begin(family), std::end(family), format) == std::end(family))
+            {
+                continue;
+            }
+
+            uint32_t viewFormatCount = 0;
+            for (VkFormat viewFormat : family)
+            {
+                if (viewFormat != VK_FORMAT_UNDEFINED)
+                {
+                    outViewFormats[viewFormatCount++] = viewFormat;
+                }
+            }
+
+            return viewFormatCount;
+        }
+
+        return 0;
+    }
+#endif
+
+    //--------------------------------------------------------------------------------------
+    // Runs the CPU processing stages requested by the load flags on the loaded subresources.
+    // The format and the alpha mode may change, and the image may get collapsed to 1x1 size
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT ProcessSubresources(VkFormat& format,
+        VkImageType imgType,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags imageCreateFlags,
+        unsigned int loadFlags,
+        DDS_ALPHA_MODE& alphaMode,
+        bool& isCollapsed,
+        std::vector<LoadedSubresourceData>& subresources,
+        LoadedTextureStorage* storage)
+    {
+        DDS_LOADER_RESULT errCode = DecompressSubresources(format, loadFlags, subresources, storage);
+
+        // Collapse first, so the rest of the stages only process a single texel
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = CollapseConstantSubresources(format, loadFlags, isCollapsed, subresources);
+        }
+
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = DropOpaqueAlpha(format, loadFlags, alphaMode, subresources, storage);
+        }
+
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = ConvertFloatSubresources(format, imageCreateFlags, loadFlags, alphaMode, subresources, storage);
+        }
+
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = CompressSubresources(format, imgType, usageFlags, imageCreateFlags, loadFlags, alphaMode, subresources, storage);
+        }
+
+        return errCode;
+    }
+
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CreateTextureResource(
+        VkDevice vkDevice,
+        VkImageType imgType,
+        size_t width,
+        size_t height,
+        size_t depth,
+        size_t mipCount,
+        size_t arraySize,
+        VkFormat format,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        bool isTypeless,
+        const VkAllocationCallbacks* allocator,
+        VkImage* texture,
+        VkImageCreateInfo* outImageCreateInfo,
+        LoadedTextureStorage* storage) noexcept
+    {
+        const bool isDeferred = (loadFlags & DDS_LOADER_DEFER_CREATION) != 0;
+        if (!vkDevice && !isDeferred)
+            return DDS_LOADER_BAD_POINTER;
+
+        DDS_LOADER_RESULT result = DDS_LOADER_FAIL;
+
+        const VkFormat linearFormat = format;
+        if(loadFlags & DDS_LOADER_FORCE_SRGB)
+        {
+            format = MakeSRGB(format);
+        }
+
+        const void* createInfoNext = nullptr;
+
+#ifdef VK_KHR_image_format_list
+        // Restrict the view formats of mutable format images, so the driver can keep them compressed
+        VkFormat viewFormats[MaxViewFormatFamilySize];
+        uint32_t viewFormatCount = 0;
+        if(loadFlags & DDS_LOADER_FORMAT_LIST)
+        {
+            if(isTypeless)
+            {
+                viewFormatCount = GetTypelessViewFormats(format, viewFormats);
+            }
+            else if((createFlags & VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT) && format != linearFormat)
+            {
+                viewFormats[0]  = linearFormat;
+                viewFormats[1]  = format;
+                viewFormatCount = 2;
+            }
+        }
+
+        // The list returned with outImageCreateInfo must be kept alive in the storage
+        std::unique_ptr<ImageFormatList> formatList;
+        if(viewFormatCount != 0)
+        {
+            formatList.reset(new (std::nothrow) ImageFormatList);
+            if(!formatList)
+            {
+                return DDS_LOADER_NO_HOST_MEMORY;
+            }
+
+            std::copy(viewFormats, viewFormats + viewFormatCount, formatList->ViewFormats);
+
+            formatList->CreateInfo.sType           = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO_KHR;
+            formatList->CreateInfo.pNext           = nullptr;
+            formatList->CreateInfo.viewFormatCount = viewFormatCount;
+            formatList->CreateInfo.pViewFormats    = formatList->ViewFormats;
+
+            createInfoNext = &formatList->CreateInfo;
+        }
+#else
+        UNREFERENCED_PARAMETER(isTypeless);
+        UNREFERENCED_PARAMETER(linearFormat);
+#endif
+
+        VkImageCreateInfo imageCreateInfo;
+        imageCreateInfo.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.pNext                 = createInfoNext;
+        imageCreateInfo.flags                 = createFlags;
+        imageCreateInfo.imageType             = imgType;
+        imageCreateInfo.format                = format;
+        imageCreateInfo.extent.width          = static_cast<uint32_t>(width);
+        imageCreateInfo.extent.height         = static_cast<uint32_t>(height);
+        imageCreateInfo.extent.depth          = static_cast<uint32_t>(depth);
+        imageCreateInfo.mipLevels             = static_cast<uint32_t>(mipCount);
+        imageCreateInfo.arrayLayers           = static_cast<uint32_t>(arraySize);
+        imageCreateInfo.samples               = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling                = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage                 = usageFlags;
+        imageCreateInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.queueFamilyIndexCount = 0;
+        imageCreateInfo.pQueueFamilyIndices   = nullptr;
+        imageCreateInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        // The format list is published only once the storage owns it, it's freed on failure
+        if(outImageCreateInfo != nullptr)
+        {
+            *outImageCreateInfo = imageCreateInfo;
+            outImageCreateInfo->pNext = nullptr;
+        }
+
+        if(isDeferred)
+        {
+            // The application creates the image from outImageCreateInfo later
+            if(texture)
+            {
+                *texture = VK_NULL_HANDLE;
+            }
+
+            result = DDS_LOADER_SUCCESS;
+        }
+        else if(vkCreateImage != nullptr)
+        {
+            VkResult vkRes = vkCreateImage(vkDevice, &imageCreateInfo, allocator, texture);
+
+            //This function only returns VK_SUCCESS, VK_ERROR_OUT_OF_HOST_MEMORY, VK_ERROR_OUT_OF_DEVICE_MEMORY
+            switch(vkRes)
+            {
+            case VK_SUCCESS:
+                result = DDS_LOADER_SUCCESS;
+                break;
+            case VK_ERROR_OUT_OF_HOST_MEMORY:
+                result = DDS_LOADER_NO_HOST_MEMORY;
+                break;
+            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
+                result = DDS_LOADER_NO_DEVICE_MEMORY;
+                break;
+            default:
+                break;
+            }
+        }
+        else
+        {
+            result = DDS_LOADER_NO_FUNCTION;
+        }
+
+        if(result == DDS_LOADER_SUCCESS)
+        {
+            if(!isDeferred)
+            {
+                assert(texture != nullptr && *texture != nullptr);
+
+                SetDebugObjectName(vkDevice, *texture, "DDSTextureLoader");
+            }
+
+#ifdef VK_KHR_image_format_list
+            if(storage)
+            {
+                storage->FormatList = std::move(formatList);
+                if(outImageCreateInfo != nullptr && storage->FormatList)
+                {
+                    outImageCreateInfo->pNext = &storage->FormatList->CreateInfo;
+                }
+            }
+#endif
+        }
+
+        return result;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // The image described by the DDS header
+    //--------------------------------------------------------------------------------------
+    struct TextureLayout
+    {
+        VkImageType        ImageType   = VK_IMAGE_TYPE_2D;
+        VkFormat           Format      = VK_FORMAT_UNDEFINED;
+        uint32_t           Width       = 0;
+        uint32_t           Height      = 0;
+        uint32_t           Depth       = 0;
+        size_t             MipCount    = 1;
+        uint32_t           ArraySize   = 1;
+        VkImageCreateFlags CreateFlags = 0;     // The flags the image requires (cube, array or mutable format)
+        bool               IsTypeless  = false;
+    };
+
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetTextureLayout(const DDS_HEADER* header, TextureLayout& layout) noexcept
+    {
+        uint32_t width  = header->width;
+        uint32_t height = header->height;
+        uint32_t depth  = header->depth;
+
+        VkImageType imgType = VK_IMAGE_TYPE_2D;
+        uint32_t arraySize = 1;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        size_t mipCount = header->mipMapCount;
+        if (0 == mipCount)
+        {
+            mipCount = 1;
+        }
+
+        VkImageCreateFlags imageCreateFlags = 0;
+        bool isTypeless = false;
+
+        if ((header->ddspf.flags & DDS_FOURCC) &&
+            (MAKEFOURCC('D', 'X', '1', '0') == header->ddspf.fourCC))
+        {
+            auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>(reinterpret_cast<const char*>(header) + sizeof(DDS_HEADER));
+
+            arraySize = d3d10ext->arraySize;
+            if(arraySize == 0)
+            {
+                return DDS_LOADER_INVALID_DATA;
+            }
+
+            if(IsTypelessFormat(d3d10ext->dxgiFormat))
+            {
+                imageCreateFlags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT;
+                isTypeless = true;
+            }
+
+            format = DXGIToVkFormat(d3d10ext->dxgiFormat);
+            if(BitsPerPixel(format) == 0)
+            {
+                return DDS_LOADER_UNSUPPORTED_FORMAT;
+            }
+
+            VkImageType imgTypeFromResDim = D3DResourceDimensionToImageType(d3d10ext->resourceDimension);
+            switch(imgTypeFromResDim)
+            {
+            case VK_IMAGE_TYPE_1D:
+                // D3DX writes 1D textures with a fixed Height of 1
+                if ((header->flags & DDS_HEIGHT) && height != 1)
+                {
+                    return DDS_LOADER_INVALID_DATA;
+                }
+                height = depth = 1;
+                break;
+
+            case VK_IMAGE_TYPE_2D:
+                if (d3d10ext->miscFlag & 0x4 /* RESOURCE_MISC_TEXTURECUBE */)
+                {
+                    imageCreateFlags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+                    arraySize *= 6;
+                }
+
+                if(arraySize > 1)
+                {
+                    imageCreateFlags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
+                }
+
+                depth = 1;
+                break;
+
+            case VK_IMAGE_TYPE_3D:
+                if (!(header->flags & DDS_HEADER_FLAGS_VOLUME))
+                {
+                    return DDS_LOADER_INVALID_DATA;
+                }
+
+                if (arraySize > 1)
+                {
+                    return DDS_LOADER_UNSUPPORTED_LAYOUT;
+                }
+                break;
+
+            default:
+                return DDS_LOADER_UNSUPPORTED_LAYOUT;
+            }
+
+            imgType = imgTypeFromResDim;
+        }
+        else
+        {
+            format = GetVkFormat(header->ddspf);
+
+            if(format == VK_FORMAT_UNDEFINED)
+            {
+                return DDS_LOADER_UNSUPPORTED_FORMAT;
+            }
+
+            if(header->flags & DDS_HEADER_FLAGS_VOLUME)
+            {
+                imgType = VK_IMAGE_TYPE_3D;
+            }
+            else
+            {
+                if (header->caps2 & DDS_CUBEMAP)
+                {
+                    // We require all six faces to be defined
+                    if ((header->caps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
+                    {
+                        return DDS_LOADER_UNSUPPORTED_LAYOUT;
+                    }
+
+                    arraySize = 6;
+                    imageCreateFlags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+                }
+
+                depth = 1;
+                imgType = VK_IMAGE_TYPE_2D;
+
+                // Note there's no way for a legacy Direct3D 9 DDS to express a '1D' texture
+            }
+
+            assert(BitsPerPixel(format) != 0);
+        }
+
+        layout.ImageType   = imgType;
+        layout.Format      = format;
+        layout.Width       = width;
+        layout.Height      = height;
+        layout.Depth       = depth;
+        layout.MipCount    = mipCount;
+        layout.ArraySize   = arraySize;
+        layout.CreateFlags = imageCreateFlags;
+        layout.IsTypeless  = isTypeless;
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Bound sizes (for security purposes we don't trust DDS file metadata larger than the Direct3D hardware requirements)
+    // Vulkan does not have an easy way to obtain this informtation - there's no corresponding VkPhysicalDeviceLimits entry
+    //--------------------------------------------------------------------------------------
+    constexpr uint32_t maxDirect3DMips = 15; /*D3D12_REQ_MIP_LEVELS*/
+
+    //--------------------------------------------------------------------------------------
+    // The image limits the loaded images are checked against
+    //--------------------------------------------------------------------------------------
+    struct ImageLimits
+    {
+        //Minimal guaranteed supported limits (refer to Table 49. Required Limits in Vulkan specification)
+        uint32_t MaxImageArrayLayers   = 256;
+        uint32_t MaxImageDimension1D   = 4096;
+        uint32_t MaxImageDimension2D   = 4096;
+        uint32_t MaxImageDimension3D   = 256;
+        uint32_t MaxImageDimensionCube = 4096;
+    };
+
+    //--------------------------------------------------------------------------------------
+    ImageLimits GetImageLimits(const VkPhysicalDeviceLimits* deviceLimits) noexcept
+    {
+        ImageLimits limits;
+        if(deviceLimits)
+        {
+            limits.MaxImageArrayLayers   = deviceLimits->maxImageArrayLayers;
+            limits.MaxImageDimension1D   = deviceLimits->maxImageDimension1D;
+            limits.MaxImageDimension2D   = deviceLimits->maxImageDimension2D;
+            limits.MaxImageDimension3D   = deviceLimits->maxImageDimension3D;
+            limits.MaxImageDimensionCube = deviceLimits->maxImageDimensionCube;
+        }
+
+        return limits;
+    }
+
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CheckTextureLimits(VkImageType imgType,
+        uint32_t width,
+        uint32_t height,
+        uint32_t depth,
+        size_t mipCount,
+        uint32_t arraySize,
+        VkImageCreateFlags imageCreateFlags,
+        const ImageLimits& limits) noexcept
+    {
+        if (mipCount > maxDirect3DMips /*D3D12_REQ_MIP_LEVELS*/ )
+        {
+            return DDS_LOADER_UNSUPPORTED_LAYOUT;
+        }
+
+        switch (imgType)
+        {
+        case VK_IMAGE_TYPE_1D:
+            if ((arraySize > limits.MaxImageArrayLayers) ||
+                (width > limits.MaxImageDimension1D))
+            {
+                return DDS_LOADER_BELOW_LIMITS;
+            }
+            break;
+
+        case VK_IMAGE_TYPE_2D:
+            if (imageCreateFlags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
+            {
+                // This is the right bound because we set arraySize to (NumCubes*6) above
+                if ((arraySize > limits.MaxImageArrayLayers) ||
+                    (width > limits.MaxImageDimensionCube) ||
+                    (height > limits.MaxImageDimensionCube))
+                {
+                    return DDS_LOADER_BELOW_LIMITS;
+                }
+            }
+            else if ((arraySize > limits.MaxImageArrayLayers) ||
+                     (width > limits.MaxImageDimension2D) ||
+                     (height > limits.MaxImageDimension2D))
+            {
+                return DDS_LOADER_BELOW_LIMITS;
+            }
+            break;
+
+        case VK_IMAGE_TYPE_3D:
+            if ((arraySize > 1) ||
+                (width > limits.MaxImageDimension3D) ||
+                (height > limits.MaxImageDimension3D) ||
+                (depth > limits.MaxImageDimension3D))
+            {
+                return DDS_LOADER_BELOW_LIMITS;
+            }
+            break;
+
+        default:
+            return DDS_LOADER_UNSUPPORTED_LAYOUT;
+        }
+
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Reads the headers and only the part of the subresource data that holds the subresource range.
+    // bitData points to the read part, which starts at bitDataOffset in all of the totalBitSize bytes of the subresource data.
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT LoadTextureRangeFromFile(
+        const char_type* fileName,
+        uint64_t fileOffset,
+        uint64_t ddsDataSize,
+        const VkImageSubresourceRange* subresourceRange,
+        std::unique_ptr<uint8_t[]>& ddsData,
+        const DDS_HEADER** header,
+        const uint8_t** bitData,
+        size_t* bitSize,
+        size_t* bitDataOffset,
+        size_t* totalBitSize) noexcept
+    {
+        if (!header || !bitData || !bitSize || !bitDataOffset || !totalBitSize)
+        {
+            return DDS_LOADER_BAD_POINTER;
+        }
+
+        alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+        const DDS_HEADER* fileHeader = nullptr;
+        uint64_t fileBitDataOffset = 0;
+        uint64_t fileBitSize = 0;
+
+        DDS_LOADER_RESULT errCode = LoadTextureHeaderFromFile(fileName, fileOffset, ddsDataSize, headerData, &fileHeader, &fileBitDataOffset, &fileBitSize);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        TextureLayout layout;
+        errCode = GetTextureLayout(fileHeader, layout);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        SubresourceRange range;
+        errCode = GetSubresourceRange(subresourceRange, layout.MipCount, layout.ArraySize, range);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+        if (numberOfPlanes == 0)
+        {
+            return DDS_LOADER_UNSUPPORTED_FORMAT;
+        }
+
+        size_t spanBegin = 0;
+        size_t spanEnd = 0;
+        size_t totalByteSize = 0;
+        errCode = GetSubresourceDataSpan(layout.Width, layout.Height, layout.Depth, layout.MipCount, layout.ArraySize,
+            numberOfPlanes, layout.Format, range, spanBegin, spanEnd, totalByteSize);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        if (totalByteSize > fileBitSize)
+        {
+            return DDS_LOADER_UNEXPECTED_EOF;
+        }
+
+        const size_t headerSize = size_t(fileBitDataOffset - fileOffset);
+        ddsData.reset(new (std::nothrow) uint8_t[headerSize + (spanEnd - spanBegin)]);
+        if (!ddsData)
+        {
+            return DDS_LOADER_NO_HOST_MEMORY;
+        }
+
+        memcpy(ddsData.get(), headerData, headerSize);
+
+        std::ifstream inFile(std::filesystem::path(fileName), std::ios::in | std::ios::binary);
+        if (!inFile)
+        {
+            ddsData.reset();
+            return DDS_LOADER_FAIL;
+        }
+
+        inFile.seekg(std::streamoff(fileBitDataOffset + spanBegin), std::ios::beg);
+        if (!ReadFileData(inFile, ddsData.get() + headerSize, spanEnd - spanBegin))
+        {
+            ddsData.reset();
+            return DDS_LOADER_FAIL;
+        }
+
+        *header        = reinterpret_cast<const DDS_HEADER*>(ddsData.get() + sizeof(uint32_t));
+        *bitData       = ddsData.get() + headerSize;
+        *bitSize       = spanEnd - spanBegin;
+        *bitDataOffset = spanBegin;
+        *totalBitSize  = size_t(std::min<uint64_t>(fileBitSize, SIZE_MAX));
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // XXH64 hash, https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    //--------------------------------------------------------------------------------------
+    constexpr uint64_t XXH64Prime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t XXH64Prime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t XXH64Prime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t XXH64Prime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t XXH64Prime5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64_t RotateLeft64(uint64_t value, int shift) noexcept
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    inline uint64_t XXH64Round(uint64_t accumulator, uint64_t input) noexcept
+    {
+        accumulator += input * XXH64Prime2;
+        accumulator  = RotateLeft64(accumulator, 31);
+        return accumulator * XXH64Prime1;
+    }
+
+    inline uint64_t XXH64MergeRound(uint64_t accumulator, uint64_t value) noexcept
+    {
+        accumulator ^= XXH64Round(0, value);
+        return accumulator * XXH64Prime1 + XXH64Prime4;
+    }
+
+    uint64_t HashXXH64(const void* data, size_t byteSize, uint64_t seed) noexcept
+    {
+        const uint8_t* input    = static_cast<const uint8_t*>(data);
+        const uint8_t* inputEnd = input + byteSize;
+
+        auto read64 = [](const uint8_t* src) { uint64_t value; memcpy(&value, src, sizeof(value)); return value; };
+        auto read32 = [](const uint8_t* src) { uint32_t value; memcpy(&value, src, sizeof(value)); return value; };
+
+        uint64_t hash = 0;
+        if (byteSize >= 32)
+        {
+            // Four independent lanes of 8-byte stripes
+            uint64_t lane1 = seed + XXH64Prime1 + XXH64Prime2;
+            uint64_t lane2 = seed + XXH64Prime2;
+            uint64_t lane3 = seed;
+            uint64_t lane4 = seed - XXH64Prime1;
+
+            const uint8_t* stripeEnd = inputEnd - 32;
+            do
+            {
+                lane1 = XXH64Round(lane1, read64(input));
+                lane2 = XXH64Round(lane2, read64(input + 8));
+                lane3 = XXH64Round(lane3, read64(input + 16));
+                lane4 = XXH64Round(lane4, read64(input + 24));
+                input += 32;
+            } while (input <= stripeEnd);
+
+            hash = RotateLeft64(lane1, 1) + RotateLeft64(lane2, 7) + RotateLeft64(lane3, 12) + RotateLeft64(lane4, 18);
+            hash = XXH64MergeRound(hash, lane1);
+            hash = XXH64MergeRound(hash, lane2);
+            hash = XXH64MergeRound(hash, lane3);
+            hash = XXH64MergeRound(hash, lane4);
+        }
+        else
+        {
+            hash = seed + XXH64Prime5;
+        }
+
+        hash += uint64_t(byteSize);
+
+        for (; inputEnd - input >= 8; input += 8)
+        {
+            hash ^= XXH64Round(0, read64(input));
+            hash  = RotateLeft64(hash, 27) * XXH64Prime1 + XXH64Prime4;
+        }
+
+        if (inputEnd - input >= 4)
+        {
+            hash ^= uint64_t(read32(input)) * XXH64Prime1;
+            hash  = RotateLeft64(hash, 23) * XXH64Prime2 + XXH64Prime3;
+            input += 4;
+        }
+
+        for (; input < inputEnd; ++input)
+        {
+            hash ^= (*input) * XXH64Prime5;
+            hash  = RotateLeft64(hash, 11) * XXH64Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= XXH64Prime2;
+        hash ^= hash >> 29;
+        hash *= XXH64Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // The key of TextureDedupCache: the hash of the headers, the loaded data and the load parameters
+    //--------------------------------------------------------------------------------------
+    uint64_t GetTextureDedupKey(const DDS_HEADER* header,
+        const uint8_t* bitData,
+        size_t bitSize,
+        size_t bitDataOffset,
+        size_t totalBitSize,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        const VkImageSubresourceRange* subresourceRange) noexcept
+    {
+        size_t headerSize = sizeof(DDS_HEADER);
+        if ((header->ddspf.flags & DDS_FOURCC) &&
+            (MAKEFOURCC('D', 'X', '1', '0') == header->ddspf.fourCC))
+        {
+            headerSize += sizeof(DDS_HEADER_DXT10);
+        }
+
+        struct DedupParameters
+        {
+            uint64_t bitDataOffset;
+            uint64_t totalBitSize;
+            uint64_t maxsize;
+            uint32_t usageFlags;
+            uint32_t createFlags;
+            uint32_t loadFlags;
+            uint32_t baseMipLevel;
+            uint32_t levelCount;
+            uint32_t baseArrayLayer;
+            uint32_t layerCount;
+            uint32_t hasRange;
+            uint32_t maxImageArrayLayers;  // The limits clamp maxsize when the image creation is retried
+            uint32_t maxImageDimension1D;
+            uint32_t maxImageDimension2D;
+            uint32_t maxImageDimension3D;
+            uint32_t maxImageDimensionCube;
+            uint32_t reserved;             // No padding bytes in the hash
+        };
+
+        DedupParameters parameters = {};
+        parameters.bitDataOffset = bitDataOffset;
+        parameters.totalBitSize  = totalBitSize;
+        parameters.maxsize       = maxsize;
+        parameters.usageFlags    = usageFlags;
+        parameters.createFlags   = createFlags;
+        parameters.loadFlags     = loadFlags;
+
+        const ImageLimits limits = GetImageLimits(deviceLimits);
+        parameters.maxImageArrayLayers   = limits.MaxImageArrayLayers;
+        parameters.maxImageDimension1D   = limits.MaxImageDimension1D;
+        parameters.maxImageDimension2D   = limits.MaxImageDimension2D;
+        parameters.maxImageDimension3D   = limits.MaxImageDimension3D;
+        parameters.maxImageDimensionCube = limits.MaxImageDimensionCube;
+
+        if (subresourceRange)
+        {
+            parameters.baseMipLevel   = subresourceRange->baseMipLevel;
+            parameters.levelCount     = subresourceRange->levelCount;
+            parameters.baseArrayLayer = subresourceRange->baseArrayLayer;
+            parameters.layerCount     = subresourceRange->layerCount;
+            parameters.hasRange       = 1;
+        }
+
+        uint64_t hash = HashXXH64(header, headerSize, 0);
+        hash = HashXXH64(bitData, bitSize, hash);
+        return HashXXH64(&parameters, sizeof(parameters), hash);
+    }
+
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CreateTextureFromDDS(VkDevice vkDevice,
+        const DDS_HEADER* header,
+        const uint8_t* bitData,
+        size_t bitSize,
+        size_t bitDataOffset,
+        size_t totalBitSize,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        VkImage* texture,
+        std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+        VkImageCreateInfo* outImageCreateInfo,
+        DDS_ALPHA_MODE* outAlphaMode,
+        LoadedTextureStorage* storage,
+        LoadMemoryBudget* memoryBudget,
+        MipDropPolicy* mipDropPolicy,
+        const VkImageSubresourceRange* subresourceRange,
+        TextureDedupCache* dedupCache) noexcept(false)
+    {
+        DDS_LOADER_RESULT errCode = DDS_LOADER_SUCCESS;
+
+        // May be changed to opaque if the loader detects that
+        DDS_ALPHA_MODE alphaMode = GetAlphaMode(header);
+
+        if (mipDropPolicy)
+        {
+            mipDropPolicy->SkippedMipCount = 0;
+        }
+
+        // Byte-identical data loaded with the same parameters gets the image created by the first load, with nothing to upload
+        uint64_t          dedupKey        = 0;
+        VkImageCreateInfo dedupCreateInfo = {};
+        if (dedupCache)
+        {
+            // The budget and the mip dropping shrink the image depending on the state of the other loads, not on the key
+            if (memoryBudget || mipDropPolicy)
+            {
+                return DDS_LOADER_INVALID_ARG;
+            }
+
+            dedupKey = GetTextureDedupKey(header, bitData, bitSize, bitDataOffset, totalBitSize, maxsize, deviceLimits, usageFlags, createFlags, loadFlags, subresourceRange);
+
+            const auto cachedTexture = dedupCache->Textures.find(dedupKey);
+            if (cachedTexture != dedupCache->Textures.end())
+            {
+                subresources.clear();
+                *texture = cachedTexture->second.Image;
+                if (outImageCreateInfo)
+                {
+                    *outImageCreateInfo = cachedTexture->second.ImageCreateInfo;
+                }
+                if (outAlphaMode)
+                {
+                    *outAlphaMode = cachedTexture->second.AlphaMode;
+                }
+                if (mipDropPolicy)
+                {
+                    mipDropPolicy->SkippedMipCount = cachedTexture->second.SkippedMipCount;
+                }
+
+                dedupCache->HitCount++;
+                dedupCache->HitByteSize += cachedTexture->second.DataByteSize;
+                return DDS_LOADER_SUCCESS;
+            }
+
+            if (!outImageCreateInfo)
+            {
+                outImageCreateInfo = &dedupCreateInfo;
+            }
+        }
+
+        TextureLayout layout;
+        errCode = GetTextureLayout(header, layout);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        VkImageType imgType   = layout.ImageType;
+        VkFormat    format    = layout.Format;
+        uint32_t    width     = layout.Width;
+        uint32_t    height    = layout.Height;
+        uint32_t    depth     = layout.Depth;
+        size_t      mipCount  = layout.MipCount;
+        uint32_t    arraySize = layout.ArraySize;
+
+        SubresourceRange range;
+        errCode = GetSubresourceRange(subresourceRange, mipCount, arraySize, range);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        // The image only holds the selected range
+        const uint32_t rangeWidth  = std::max<uint32_t>(width  >> range.BaseMip, 1);
+        const uint32_t rangeHeight = std::max<uint32_t>(height >> range.BaseMip, 1);
+        const uint32_t rangeDepth  = std::max<uint32_t>(depth  >> range.BaseMip, 1);
+        const uint32_t rangeLayers = static_cast<uint32_t>(range.LayerCount);
+
+        VkImageCreateFlags layoutCreateFlags = layout.CreateFlags;
+        if ((range.BaseLayer % 6) != 0 || (range.LayerCount % 6) != 0)
+        {
+            // Not whole cubes anymore
+            layoutCreateFlags &= ~VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        }
+
+        if (rangeLayers <= 1)
+        {
+            layoutCreateFlags &= ~VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
+        }
+
+        VkImageCreateFlags imageCreateFlags = createFlags | layoutCreateFlags;
+        bool isTypeless = layout.IsTypeless;
+
+        if (loadFlags & DDS_LOADER_SPARSE_RESIDENCY)
+        {
+            imageCreateFlags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+        }
+
+        const ImageLimits limits = GetImageLimits(deviceLimits);
+        errCode = CheckTextureLimits(imgType, rangeWidth, rangeHeight, rangeDepth, range.MipCount, rangeLayers, imageCreateFlags, limits);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        uint32_t numberOfPlanes = GetVkFormatPlaneCount(format);
+        if(numberOfPlanes == 0)
+        {
+            return DDS_LOADER_UNSUPPORTED_FORMAT;
+        }
+
+        if ((numberOfPlanes > 1) && IsDepthStencil(format))
+        {
+            // For the future (at the moment of writing this Vulkan doesn't have any multi-planar depth-stencil format support)
+            return DDS_LOADER_UNSUPPORTED_FORMAT;
+        }
+
+        // Create the texture
+        size_t numberOfResources = (imgType == VK_IMAGE_TYPE_3D)
+                                   ? 1 : rangeLayers;
+        numberOfResources *= range.MipCount;
+        numberOfResources *= numberOfPlanes;
+
+        //Vulkan doesn't have any subresource number limit
+        subresources.reserve(numberOfResources);
+
+        if (memoryBudget)
+        {
+            // Estimate the size with the decompressed format, the other processing stages only make the data smaller
+            VkFormat budgetFormat = GetDecompressedFormat(format, loadFlags);
+            if (budgetFormat == VK_FORMAT_UNDEFINED)
+            {
+                budgetFormat = format;
+            }
+
+            size_t budgetByteSize = 0;
+            if (memoryBudget->BudgetByteSize > memoryBudget->UsedByteSize)
+            {
+                budgetByteSize = memoryBudget->BudgetByteSize - memoryBudget->UsedByteSize;
+            }
+
+            size_t budgetMaxSize = 0;
+            errCode = GetBudgetMaxSize(rangeWidth, rangeHeight, rangeDepth, range.MipCount, rangeLayers,
+                numberOfPlanes, budgetFormat, budgetByteSize, budgetMaxSize);
+            if (errCode != DDS_LOADER_SUCCESS)
+            {
+                return errCode;
+            }
+
+            if (budgetMaxSize && (!maxsize || budgetMaxSize < maxsize))
+            {
+                maxsize = budgetMaxSize;
+            }
+        }
+
+        size_t skipMip = 0;
+        size_t twidth = 0;
         size_t theight = 0;
         size_t tdepth = 0;
         errCode = FillInitData(width, height, depth, mipCount, arraySize,
             numberOfPlanes, format,
-            maxsize, bitSize, bitData,
+            maxsize, bitSize, bitData, bitDataOffset, totalBitSize, range,
             twidth, theight, tdepth, skipMip, subresources);
 
-        if (errCode == DDS_LOADER_SUCCESS)
-        {
-            size_t reservedMips = mipCount;
-            if (loadFlags & DDS_LOADER_MIP_RESERVE)
-            {
-                reservedMips = std::min<size_t>(maxDirect3DMips,
-                    CountMips(width, height));
-            }
+        // The format of the created image, differs from the file format if the data gets transcoded
+        VkFormat imageFormat = format;
+        bool     isCollapsed = false;
+        size_t   imageMips   = 0;
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = ProcessSubresources(imageFormat, imgType, usageFlags, imageCreateFlags, loadFlags, alphaMode, isCollapsed, subresources, storage);
+        }
+
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            size_t reservedMips = range.MipCount;
+            if (loadFlags & DDS_LOADER_MIP_RESERVE)
+            {
+                reservedMips = std::min<size_t>(maxDirect3DMips,
+                    CountMips(rangeWidth, rangeHeight));
+            }
+
+            if (isCollapsed)
+            {
+                twidth = theight = tdepth = 1;
+                reservedMips = 1;
+                skipMip = 0;
+            }
+
+            imageMips = reservedMips - skipMip;
+            errCode = CreateTextureResource(vkDevice, imgType, twidth, theight, tdepth, imageMips, rangeLayers,
+                imageFormat, usageFlags, imageCreateFlags, loadFlags, isTypeless, allocationCallbacks, texture, outImageCreateInfo, storage);
+
+            // Out of memory is handled by dropping mips one by one below, the images are already within the device limits
+            const bool isDroppingMips = mipDropPolicy && errCode == DDS_LOADER_NO_DEVICE_MEMORY;
+            if (errCode != DDS_LOADER_SUCCESS && !maxsize && (range.MipCount > 1) && !isDroppingMips)
+            {
+                subresources.clear();
+
+                maxsize = static_cast<size_t>(
+                    (imgType == VK_IMAGE_TYPE_3D)
+                    ? limits.MaxImageDimension3D
+                    : limits.MaxImageDimension2D);
+
+                errCode = FillInitData(width, height, depth, mipCount, arraySize,
+                    numberOfPlanes, format,
+                    maxsize, bitSize, bitData, bitDataOffset, totalBitSize, range,
+                    twidth, theight, tdepth, skipMip, subresources);
+
+                imageFormat = format;
+                if (errCode == DDS_LOADER_SUCCESS)
+                {
+                    errCode = ProcessSubresources(imageFormat, imgType, usageFlags, imageCreateFlags, loadFlags, alphaMode, isCollapsed, subresources, storage);
+                }
+
+                if (errCode == DDS_LOADER_SUCCESS)
+                {
+                    imageMips = range.MipCount - skipMip;
+                    if (isCollapsed)
+                    {
+                        twidth = theight = tdepth = 1;
+                        imageMips = 1;
+                        skipMip = 0;
+                    }
+
+                    errCode = CreateTextureResource(vkDevice, imgType, twidth, theight, tdepth, imageMips, rangeLayers,
+                        imageFormat, usageFlags, imageCreateFlags, loadFlags, isTypeless, allocationCallbacks, texture, outImageCreateInfo, storage);
+                }
+            }
+
+            // Drop the top mip of the already loaded subresources one by one until the image fits into the device memory
+            if (mipDropPolicy)
+            {
+                const size_t minMips = std::max<size_t>(mipDropPolicy->MinMipCount, 1);
+                while (errCode == DDS_LOADER_NO_DEVICE_MEMORY && imageMips > minMips && !subresources.empty())
+                {
+                    // The subresource mip levels are the file mip levels, so the top loaded one is BaseMip + skipMip
+                    const uint32_t topMip = static_cast<uint32_t>(range.BaseMip + skipMip);
+                    subresources.erase(std::remove_if(subresources.begin(), subresources.end(), [topMip](const LoadedSubresourceData& subresource)
+                    {
+                        return subresource.SubresourceSlice.mipLevel == topMip;
+                    }), subresources.end());
+
+                    if (subresources.empty())
+                    {
+                        break;
+                    }
+
+                    ++skipMip;
+                    --imageMips;
+                    twidth  = std::max<size_t>(twidth  >> 1, 1);
+                    theight = std::max<size_t>(theight >> 1, 1);
+                    tdepth  = std::max<size_t>(tdepth  >> 1, 1);
+
+                    errCode = CreateTextureResource(vkDevice, imgType, twidth, theight, tdepth, imageMips, rangeLayers,
+                        imageFormat, usageFlags, imageCreateFlags, loadFlags, isTypeless, allocationCallbacks, texture, outImageCreateInfo, storage);
+                }
+
+                mipDropPolicy->SkippedMipCount = static_cast<uint32_t>(skipMip);
+            }
+        }
+
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            subresources.clear();
+            return errCode;
+        }
+
+        // The image only has the loaded subresources, return its mip levels and array layers
+        for (LoadedSubresourceData& subresource : subresources)
+        {
+            subresource.SubresourceSlice.mipLevel   -= static_cast<uint32_t>(range.BaseMip + skipMip);
+            subresource.SubresourceSlice.arrayLayer -= static_cast<uint32_t>(range.BaseLayer);
+        }
+
+        if (outAlphaMode)
+        {
+            *outAlphaMode = alphaMode;
+        }
+
+        size_t dataByteSize = 0;
+        for (const LoadedSubresourceData& subresource : subresources)
+        {
+            dataByteSize += subresource.DataByteSize;
+        }
+
+        if (memoryBudget)
+        {
+            memoryBudget->UsedByteSize += dataByteSize;
+        }
+
+        if (dedupCache)
+        {
+            TextureDedupCache::CachedTexture cachedTexture;
+            cachedTexture.Image                 = *texture;
+            cachedTexture.ImageCreateInfo       = *outImageCreateInfo;
+            cachedTexture.ImageCreateInfo.pNext = nullptr;
+            cachedTexture.AlphaMode             = alphaMode;
+            cachedTexture.SkippedMipCount       = static_cast<uint32_t>(skipMip);
+            cachedTexture.DataByteSize          = dataByteSize;
+
+            dedupCache->Textures.emplace(dedupKey, cachedTexture);
+            dedupCache->MissCount++;
+        }
+
+        return errCode;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Lists the subresources that are loaded with the given maxsize, with the file mip levels, and their offsets
+    // from the start of the DDS data, in the data order (plane, array layer, mip level)
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT GetDataSubresources(const TextureLayout& layout,
+        uint32_t numberOfPlanes,
+        size_t maxsize,
+        uint64_t bitDataOffset,
+        uint64_t bitSize,
+        std::vector<LoadedSubresourceData>& dataSubresources,
+        std::vector<uint64_t>& dataOffsets,
+        size_t& skipMip) noexcept(false)
+    {
+        const size_t mipCount = layout.MipCount;
+
+        dataSubresources.clear();
+        dataOffsets.clear();
+        skipMip = 0;
+
+        size_t totalByteSize = 0;
+        DDS_LOADER_RESULT errCode = VisitDataSubresources(layout.Width, layout.Height, layout.Depth, mipCount, layout.ArraySize,
+            numberOfPlanes, layout.Format, totalByteSize,
+            [&](size_t p, VkImageAspectFlags aspectPlane, size_t j, size_t i, size_t w, size_t h, size_t d, size_t srcOffset, size_t dataSize)
+        {
+            // Same mip skipping as FillInitData
+            if ((mipCount <= 1) || !maxsize || (w <= maxsize && h <= maxsize && d <= maxsize))
+            {
+                LoadedSubresourceData res;
+                res.PData                       = nullptr;
+                res.DataByteSize                = dataSize;
+                res.SubresourceSlice.aspectMask = aspectPlane;
+                res.SubresourceSlice.arrayLayer = static_cast<uint32_t>(j);
+                res.SubresourceSlice.mipLevel   = static_cast<uint32_t>(i);
+                res.Extent.width                = static_cast<uint32_t>(w);
+                res.Extent.height               = static_cast<uint32_t>(h);
+                res.Extent.depth                = static_cast<uint32_t>(d);
+
+                dataSubresources.push_back(res);
+                dataOffsets.push_back(bitDataOffset + srcOffset);
+            }
+            else if (!p && !j)
+            {
+                ++skipMip;
+            }
+
+            return DDS_LOADER_SUCCESS;
+        });
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        if (dataSubresources.empty())
+        {
+            return DDS_LOADER_FAIL;
+        }
+
+        if (totalByteSize > bitSize)
+        {
+            return DDS_LOADER_UNEXPECTED_EOF;
+        }
+
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Creates the image for the loaders that read the subresource data by themselves. Returns the subresources
+    // that have to be read, with the file mip levels, and their offsets from the start of the DDS data, in the data order.
+    //--------------------------------------------------------------------------------------
+    // The flags that process the data on CPU, they need all mip levels of a single file at once
+    constexpr unsigned int ProcessingLoadFlags = DDS_LOADER_DECOMPRESS_ETC2 | DDS_LOADER_DECOMPRESS_ASTC | DDS_LOADER_COMPRESS_BC
+        | DDS_LOADER_DROP_OPAQUE_ALPHA | DDS_LOADER_CONVERT_FLOAT | DDS_LOADER_COLLAPSE_CONSTANT;
+
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT CreateTextureFromHeader(VkDevice vkDevice,
+        const DDS_HEADER* header,
+        uint64_t bitDataOffset,
+        uint64_t bitSize,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocator,
+        VkImage* texture,
+        VkImageCreateInfo* outImageCreateInfo,
+        LoadedTextureStorage* storage,
+        std::vector<LoadedSubresourceData>& dataSubresources,
+        std::vector<uint64_t>& dataOffsets,
+        size_t& skipMip) noexcept(false)
+    {
+        // The image format must be known before the first mip is read
+        if (loadFlags & ProcessingLoadFlags)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        TextureLayout layout;
+        DDS_LOADER_RESULT errCode = GetTextureLayout(header, layout);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        VkImageCreateFlags imageCreateFlags = createFlags | layout.CreateFlags;
+        if (loadFlags & DDS_LOADER_SPARSE_RESIDENCY)
+        {
+            imageCreateFlags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+        }
+
+        errCode = CheckTextureLimits(layout.ImageType, layout.Width, layout.Height, layout.Depth, layout.MipCount, layout.ArraySize,
+            imageCreateFlags, GetImageLimits(deviceLimits));
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+        if (numberOfPlanes == 0 || ((numberOfPlanes > 1) && IsDepthStencil(layout.Format)))
+        {
+            return DDS_LOADER_UNSUPPORTED_FORMAT;
+        }
+
+        errCode = GetDataSubresources(layout, numberOfPlanes, maxsize, bitDataOffset, bitSize, dataSubresources, dataOffsets, skipMip);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        size_t imageMips = layout.MipCount;
+        if (loadFlags & DDS_LOADER_MIP_RESERVE)
+        {
+            imageMips = std::min<size_t>(maxDirect3DMips, CountMips(layout.Width, layout.Height));
+        }
+
+        const VkExtent3D& topExtent = dataSubresources.front().Extent;
+        return CreateTextureResource(vkDevice, layout.ImageType, topExtent.width, topExtent.height, topExtent.depth, imageMips - skipMip, layout.ArraySize,
+            layout.Format, usageFlags, imageCreateFlags, loadFlags, layout.IsTypeless, allocator, texture, outImageCreateInfo, storage);
+    }
+
+    //--------------------------------------------------------------------------------------
+    // A whole DDS file loaded by LoadTextureFiles
+    //--------------------------------------------------------------------------------------
+    struct TextureFile
+    {
+        DDS_LOADER_RESULT Result  = DDS_LOADER_SUCCESS;
+        const DDS_HEADER* Header  = nullptr;
+        const uint8_t*    BitData = nullptr;
+        size_t            BitSize = 0;
+        TextureLayout     Layout;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Reads the files in parallel and parses their headers. The result of every file is in its Result
+    //--------------------------------------------------------------------------------------
+    void LoadTextureFiles(const char_type* const* fileNames,
+        size_t fileCount,
+        std::vector<std::unique_ptr<uint8_t[]>>& ddsData,
+        std::vector<TextureFile>& files)
+    {
+        files.assign(fileCount, TextureFile());
+        ddsData.resize(fileCount);
+
+        // The reads are mostly waiting for the storage, so every file gets its own task
+        ParallelFor(fileCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                TextureFile& file = files[i];
+                file.Result = fileNames[i]
+                    ? LoadTextureDataFromFile(fileNames[i], 0, WholeFileDataSize, ddsData[i], &file.Header, &file.BitData, &file.BitSize)
+                    : DDS_LOADER_INVALID_ARG;
+                if (file.Result == DDS_LOADER_SUCCESS)
+                {
+                    file.Result = GetTextureLayout(file.Header, file.Layout);
+                }
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Texture pack archive structure definitions, all offsets are from the start of the archive.
+    // The archive is TEXTURE_PACK_HEADER, the stored subresource payloads of every texture, the DDS headers,
+    // the table of contents sorted by the name hash, the subresource table and the texture names.
+    //
+    // The payload layout of a texture has every subresource aligned for the buffer to image copies.
+    // Uncompressed textures are stored in the payload layout, compressed ones store every subresource
+    // as a separate LZ4 block, or as is if it doesn't compress
+    //--------------------------------------------------------------------------------------
+    constexpr uint32_t TEXTURE_PACK_MAGIC   = MAKEFOURCC('D', 'D', 'S', 'P');
+    constexpr uint32_t TEXTURE_PACK_VERSION = 1;
+
+    constexpr uint32_t TEXTURE_PACK_TEXTURE_COMPRESSED = 0x1;
+
+    struct TEXTURE_PACK_HEADER
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t textureCount;
+        uint32_t subresourceCount;
+        uint64_t tocOffset;            // TEXTURE_PACK_TOC_ENTRY[textureCount]
+        uint64_t subresourceOffset;    // TEXTURE_PACK_SUBRESOURCE[subresourceCount]
+        uint64_t namesOffset;          // Null-terminated texture names
+        uint64_t namesSize;
+        uint64_t copyOffsetAlignment;
+    };
+
+    struct TEXTURE_PACK_TOC_ENTRY
+    {
+        uint64_t nameHash;
+        uint64_t nameOffset;           // From namesOffset
+        uint64_t headerOffset;         // The DDS magic number and headers
+        uint64_t headerSize;
+        uint64_t storedOffset;         // The stored subresources of the texture
+        uint64_t storedSize;
+        uint64_t payloadSize;          // The size of the payload layout
+        uint64_t bitSize;              // The size of the subresource data in the DDS file
+        uint32_t firstSubresource;
+        uint32_t subresourceCount;
+        uint32_t flags;                // TEXTURE_PACK_TEXTURE_COMPRESSED
+        uint32_t reserved;
+    };
+
+    struct TEXTURE_PACK_SUBRESOURCE
+    {
+        uint64_t sourceOffset;         // From the start of the subresource data in the DDS file
+        uint64_t payloadOffset;        // From the start of the payload layout
+        uint64_t dataByteSize;
+        uint64_t storedOffset;         // From the storedOffset of the texture
+        uint64_t storedByteSize;       // Same as dataByteSize if stored uncompressed
+    };
+
+    static_assert(sizeof(TEXTURE_PACK_HEADER)      == 56, "Texture pack header size mismatch");
+    static_assert(sizeof(TEXTURE_PACK_TOC_ENTRY)   == 80, "Texture pack TOC entry size mismatch");
+    static_assert(sizeof(TEXTURE_PACK_SUBRESOURCE) == 40, "Texture pack subresource size mismatch");
+
+    //--------------------------------------------------------------------------------------
+    // LZ4 block format codec. Only the block format is used, every subresource is a separate block
+    // https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+    //--------------------------------------------------------------------------------------
+    constexpr size_t Lz4MinMatch     = 4;
+    constexpr size_t Lz4LastLiterals = 5;  // The last bytes of the block are always literals
+    constexpr size_t Lz4MatchLimit   = 12; // The last match starts at least this many bytes before the end of the block
+    constexpr size_t Lz4MaxOffset    = 65535;
+    constexpr uint32_t Lz4HashLog    = 16;
+
+    inline uint32_t ReadLz4Sequence(const uint8_t* src) noexcept
+    {
+        uint32_t value;
+        memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Greedy single-pass compressor. Returns the compressed size, or 0 if the block doesn't fit into dstCapacity
+    //--------------------------------------------------------------------------------------
+    size_t CompressLz4Block(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity, size_t* hashTable) noexcept
+    {
+        size_t op = 0;
+        auto writeLength = [&](size_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                if (op == dstCapacity)
+                    return false;
+                dst[op++] = 255;
+            }
+
+            if (op == dstCapacity)
+                return false;
+            dst[op++] = static_cast<uint8_t>(length);
+            return true;
+        };
+
+        auto writeSequence = [&](size_t literalStart, size_t literalLength, size_t offset, size_t matchLength)
+        {
+            if (op == dstCapacity)
+                return false;
+
+            const size_t matchToken = matchLength ? matchLength - Lz4MinMatch : 0;
+            dst[op++] = static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchToken, 15));
+            if (literalLength >= 15 && !writeLength(literalLength - 15))
+                return false;
+
+            if (literalLength > dstCapacity - op)
+                return false;
+            if (literalLength)
+                memcpy(dst + op, src + literalStart, literalLength);
+            op += literalLength;
+
+            if (!matchLength)
+                return true;
+
+            if (dstCapacity - op < 2)
+                return false;
+            dst[op++] = static_cast<uint8_t>(offset);
+            dst[op++] = static_cast<uint8_t>(offset >> 8);
+
+            return matchToken < 15 || writeLength(matchToken - 15);
+        };
+
+        constexpr size_t noPosition = SIZE_MAX;
+        std::fill(hashTable, hashTable + (size_t(1) << Lz4HashLog), noPosition);
+
+        size_t anchor = 0;
+        size_t ip     = 0;
+        while (ip + Lz4MatchLimit <= srcSize)
+        {
+            const uint32_t sequence = ReadLz4Sequence(src + ip);
+            const uint32_t hash     = (sequence * 2654435761u) >> (32 - Lz4HashLog);
+
+            const size_t ref = hashTable[hash];
+            hashTable[hash] = ip;
+
+            if (ref == noPosition || ip - ref > Lz4MaxOffset || ReadLz4Sequence(src + ref) != sequence)
+            {
+                ip++;
+                continue;
+            }
+
+            size_t matchLength = Lz4MinMatch;
+            while (ip + matchLength < srcSize - Lz4LastLiterals && src[ref + matchLength] == src[ip + matchLength])
+            {
+                matchLength++;
+            }
+
+            if (!writeSequence(anchor, ip - anchor, ip - ref, matchLength))
+                return 0;
+
+            ip    += matchLength;
+            anchor = ip;
+        }
+
+        if (!writeSequence(anchor, srcSize - anchor, 0, 0))
+            return 0;
+
+        return op;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Decompresses the block that has to expand to exactly dstSize bytes. Returns false for malformed blocks
+    //--------------------------------------------------------------------------------------
+    bool DecompressLz4Block(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) noexcept
+    {
+        auto readLength = [&](size_t& ip, size_t& length)
+        {
+            uint8_t value = 255;
+            while (value == 255)
+            {
+                if (ip == srcSize)
+                    return false;
+                value   = src[ip++];
+                length += value;
+            }
+            return true;
+        };
+
+        size_t ip = 0;
+        size_t op = 0;
+        while (ip < srcSize)
+        {
+            const uint8_t token = src[ip++];
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(ip, literalLength))
+                return false;
+
+            if (literalLength > srcSize - ip || literalLength > dstSize - op)
+                return false;
+
+            if (literalLength)
+                memcpy(dst + op, src + ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            // The last sequence has no match
+            if (ip == srcSize)
+                break;
+
+            if (srcSize - ip < 2)
+                return false;
+
+            const size_t offset = size_t(src[ip]) | (size_t(src[ip + 1]) << 8);
+            ip += 2;
+
+            size_t matchLength = token & 0xF;
+            if (matchLength == 15 && !readLength(ip, matchLength))
+                return false;
+            matchLength += Lz4MinMatch;
+
+            if (offset == 0 || offset > op || matchLength > dstSize - op)
+                return false;
+
+            const uint8_t* match = dst + op - offset;
+            if (offset >= matchLength)
+            {
+                memcpy(dst + op, match, matchLength);
+            }
+            else
+            {
+                // Overlapping match repeats the last offset bytes
+                for (size_t i = 0; i < matchLength; i++)
+                {
+                    dst[op + i] = match[i];
+                }
+            }
+
+            op += matchLength;
+        }
+
+        return op == dstSize;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // FNV-1a hash of the texture name
+    //--------------------------------------------------------------------------------------
+    inline uint64_t HashTexturePackName(const char* name) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (; *name; ++name)
+        {
+            hash ^= static_cast<uint8_t>(*name);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Copies or decompresses the stored subresource of the texture into dst
+    //--------------------------------------------------------------------------------------
+    bool ReadTexturePackSubresource(const uint8_t* storedData, const TEXTURE_PACK_SUBRESOURCE& subresource, uint8_t* dst) noexcept
+    {
+        const uint8_t* src = storedData + subresource.storedOffset;
+        if (subresource.storedByteSize == subresource.dataByteSize)
+        {
+            memcpy(dst, src, size_t(subresource.dataByteSize));
+            return true;
+        }
+
+        return DecompressLz4Block(src, size_t(subresource.storedByteSize), dst, size_t(subresource.dataByteSize));
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Writes zeros up to the next multiple of alignment
+    //--------------------------------------------------------------------------------------
+    void PadFileData(std::ofstream& outFile, uint64_t& fileOffset, uint64_t alignment)
+    {
+        static const char zeros[256] = {};
+
+        uint64_t paddingSize = (alignment - fileOffset % alignment) % alignment;
+        fileOffset += paddingSize;
+        while (paddingSize > 0)
+        {
+            const uint64_t chunkSize = std::min<uint64_t>(paddingSize, sizeof(zeros));
+            outFile.write(zeros, std::streamsize(chunkSize));
+            paddingSize -= chunkSize;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Maps the whole file for reading. mappingHandle has to be passed back to UnmapFile()
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT MapFile(const char_type* fileName, const uint8_t** outData, size_t* outByteSize, void** outMappingHandle) noexcept
+    {
+        *outData          = nullptr;
+        *outByteSize      = 0;
+        *outMappingHandle = nullptr;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(std::filesystem::path(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return DDS_LOADER_FAIL;
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 || uint64_t(fileSize.QuadPart) > SIZE_MAX)
+        {
+            CloseHandle(file);
+            return DDS_LOADER_FAIL;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping)
+            return DDS_LOADER_FAIL;
+
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            return DDS_LOADER_FAIL;
+        }
+
+        *outData          = static_cast<const uint8_t*>(view);
+        *outByteSize      = size_t(fileSize.QuadPart);
+        *outMappingHandle = mapping;
+#else
+        const std::string path = std::filesystem::path(fileName).string();
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return DDS_LOADER_FAIL;
+
+        struct stat fileStat = {};
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0 || uint64_t(fileStat.st_size) > SIZE_MAX)
+        {
+            close(file);
+            return DDS_LOADER_FAIL;
+        }
+
+        void* view = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED)
+            return DDS_LOADER_FAIL;
+
+        *outData     = static_cast<const uint8_t*>(view);
+        *outByteSize = size_t(fileStat.st_size);
+#endif
+
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    void UnmapFile(const uint8_t* data, size_t byteSize, void* mappingHandle) noexcept
+    {
+        if (!data)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UNREFERENCED_PARAMETER(byteSize);
+        UnmapViewOfFile(data);
+        CloseHandle(mappingHandle);
+#else
+        UNREFERENCED_PARAMETER(mappingHandle);
+        munmap(const_cast<uint8_t*>(data), byteSize);
+#endif
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Texture index file structure definitions, all offsets are from the start of the file.
+    // The index is TEXTURE_INDEX_HEADER, the entries sorted by the name hash, the subresources
+    // of every entry (DDSTextureLoaderVk::IndexedSubresource) and the file names
+    //--------------------------------------------------------------------------------------
+    constexpr uint32_t TEXTURE_INDEX_MAGIC   = MAKEFOURCC('D', 'D', 'S', 'X');
+    constexpr uint32_t TEXTURE_INDEX_VERSION = 1;
+
+    struct TEXTURE_INDEX_HEADER
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t textureCount;
+        uint32_t subresourceCount;
+        uint64_t entriesOffset;        // TEXTURE_INDEX_ENTRY[textureCount]
+        uint64_t subresourceOffset;    // IndexedSubresource[subresourceCount]
+        uint64_t namesOffset;          // Null-terminated UTF-8 file names
+        uint64_t namesSize;
+    };
+
+    struct TEXTURE_INDEX_ENTRY
+    {
+        uint64_t nameHash;
+        uint64_t nameOffset;           // From namesOffset
+        uint64_t fileSize;
+        int64_t  lastWriteTime;
+        uint32_t imageType;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t mipLevels;
+        uint32_t arrayLayers;
+        uint32_t createFlags;
+        uint32_t alphaMode;
+        uint32_t firstSubresource;
+        uint32_t subresourceCount;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(TEXTURE_INDEX_HEADER)                    == 48, "Texture index header size mismatch");
+    static_assert(sizeof(TEXTURE_INDEX_ENTRY)                     == 80, "Texture index entry size mismatch");
+    static_assert(sizeof(DDSTextureLoaderVk::IndexedSubresource) == 40, "Texture index subresource size mismatch");
+
+    //--------------------------------------------------------------------------------------
+    std::string GetUtf8FileName(const std::filesystem::path& path)
+    {
+#ifdef __cpp_char8_t
+        const std::u8string fileName = path.filename().u8string();
+        return std::string(fileName.begin(), fileName.end());
+#else
+        return path.filename().u8string();
+#endif
+    }
+
+    //--------------------------------------------------------------------------------------
+    // Parses the headers of the DDS file into the index entry and its subresources, with the file offsets
+    //--------------------------------------------------------------------------------------
+    DDS_LOADER_RESULT IndexTextureFile(const char_type* fileName,
+        TEXTURE_INDEX_ENTRY& entry,
+        std::vector<DDSTextureLoaderVk::IndexedSubresource>& subresources) noexcept(false)
+    {
+        alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+        const DDS_HEADER* header = nullptr;
+        uint64_t bitDataOffset = 0;
+        uint64_t bitSize = 0;
+
+        DDS_LOADER_RESULT errCode = LoadTextureHeaderFromFile(fileName, 0, WholeFileDataSize, headerData, &header, &bitDataOffset, &bitSize);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        TextureLayout layout;
+        errCode = GetTextureLayout(header, layout);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+        if (numberOfPlanes == 0)
+        {
+            return DDS_LOADER_UNSUPPORTED_FORMAT;
+        }
+
+        std::vector<LoadedSubresourceData> dataSubresources;
+        std::vector<uint64_t>              dataOffsets;
+        size_t                             skipMip = 0;
+
+        errCode = GetDataSubresources(layout, numberOfPlanes, 0, bitDataOffset, bitSize, dataSubresources, dataOffsets, skipMip);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        entry.imageType   = static_cast<uint32_t>(layout.ImageType);
+        entry.format      = static_cast<uint32_t>(layout.Format);
+        entry.width       = layout.Width;
+        entry.height      = layout.Height;
+        entry.depth       = layout.Depth;
+        entry.mipLevels   = static_cast<uint32_t>(layout.MipCount);
+        entry.arrayLayers = layout.ArraySize;
+        entry.createFlags = static_cast<uint32_t>(layout.CreateFlags);
+        entry.alphaMode   = static_cast<uint32_t>(GetAlphaMode(header));
+
+        subresources.clear();
+        subresources.reserve(dataSubresources.size());
+        for (size_t k = 0; k < dataSubresources.size(); k++)
+        {
+            DDSTextureLoaderVk::IndexedSubresource subresource;
+            subresource.SubresourceSlice = dataSubresources[k].SubresourceSlice;
+            subresource.Extent           = dataSubresources[k].Extent;
+            subresource.FileOffset       = dataOffsets[k];
+            subresource.DataByteSize     = dataSubresources[k].DataByteSize;
+            subresources.push_back(subresource);
+        }
+
+        return DDS_LOADER_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------------------
+    bool IsValidTextureOutput(VkDevice vkDevice,
+        const VkImage* texture,
+        const VkImageCreateInfo* outImageCreateInfo,
+        unsigned int loadFlags,
+        const TextureDedupCache* dedupCache) noexcept
+    {
+        // Deferred creation needs no device, only the create info. The dedup cache can't share the images that don't exist yet
+        if (loadFlags & DDS_LOADER_DEFER_CREATION)
+        {
+            return outImageCreateInfo != nullptr && dedupCache == nullptr;
+        }
+
+        return vkDevice != VK_NULL_HANDLE && texture != nullptr;
+    }
+
+    //--------------------------------------------------------------------------------------
+    void SetDebugTextureInfo(
+        VkDevice device,
+        const char* fileName,
+        VkImage image) noexcept
+    {
+#if defined(VK_EXT_debug_utils) && !defined(NO_VK_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
+        if(image != VK_NULL_HANDLE)
+        {
+            const char* pstrName = strrchr(fileName, '\\');
+            if (!pstrName)
+            {
+                pstrName = fileName;
+            }
+            else
+            {
+                pstrName++;
+            }
+
+            VkDebugUtilsObjectNameInfoEXT debugObjectNameInfo;
+            debugObjectNameInfo.sType        = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+            debugObjectNameInfo.pNext        = nullptr;
+            debugObjectNameInfo.objectType   = VK_OBJECT_TYPE_IMAGE;
+            debugObjectNameInfo.objectHandle = (uint64_t)image;
+            debugObjectNameInfo.pObjectName  = fileName;
+
+            if(vkSetDebugUtilsObjectNameEXT != nullptr)
+            {
+                vkSetDebugUtilsObjectNameEXT(device, &debugObjectNameInfo);
+            }
+        }
+#else
+        UNREFERENCED_PARAMETER(device);
+        UNREFERENCED_PARAMETER(fileName);
+        UNREFERENCED_PARAMETER(image);
+#endif
+    }
+} // anonymous namespace
+
+#ifdef VK_NO_PROTOTYPES
+
+    void DDSTextureLoaderVk::SetVkCreateImageFuncPtr(PFN_vkCreateImage funcPtr)
+    {
+        vkCreateImage = funcPtr;
+    }
+
+    void DDSTextureLoaderVk::SetVkCreateImageFuncPtrWithUserPtr(DDSTextureLoaderVk::PFN_DdsLoader_vkCreateImageUserPtr funcPtr)
+    {
+        vkCreateImageWithUserPtr = funcPtr;
+
+        vkCreateImage = [](VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage)
+        {
+            return vkCreateImageWithUserPtr(vkCreateImageUserPtr, device, pCreateInfo, pAllocator, pImage);
+        };
+    }
+
+    void DDSTextureLoaderVk::SetVkCreateImageUserPtr(void* userPtr)
+    {
+        vkCreateImageUserPtr = userPtr;
+    }
+
+#ifdef VK_EXT_debug_utils
+
+    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameFuncPtr(PFN_vkSetDebugUtilsObjectNameEXT funcPtr)
+    {
+        vkSetDebugUtilsObjectNameEXT = funcPtr;
+    }
+
+    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameFuncPtrWithUserPtr(DDSTextureLoaderVk::PFN_DdsLoader_vkSetDebugUtilsObjectNameUserPtr funcPtr)
+    {
+        vkSetDebugUtilsObjectNameEXTWithUserPtr = funcPtr;
+
+        vkSetDebugUtilsObjectNameEXT = [](VkDevice device, const VkDebugUtilsObjectNameInfoEXT* pNameInfo)
+        {
+            return vkSetDebugUtilsObjectNameEXTWithUserPtr(vkSetDebugUtilsObjectNameEXTUserPtr, device, pNameInfo);
+        };
+    }
+
+    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr)
+    {
+        vkSetDebugUtilsObjectNameEXTUserPtr = userPtr;
+    }
+
+#endif // VK_EXT_debug_utils
+#endif // VK_NO_PROTOTYPES
+
+std::string DDSLoaderResultToString(DDS_LOADER_RESULT errorCode)
+{
+    switch (errorCode)
+    {
+    case DDSTextureLoaderVk::DDS_LOADER_SUCCESS:
+        return "Operation was successful.";
+    case DDSTextureLoaderVk::DDS_LOADER_FAIL:
+        return "Unexpected failure when reading the file.";
+    case DDSTextureLoaderVk::DDS_LOADER_BAD_POINTER:
+        return "Incorrect pointer has been passed to the function.";
+    case DDSTextureLoaderVk::DDS_LOADER_INVALID_ARG:
+        return "Incorrect argument has been passed to the function.";
+    case DDSTextureLoaderVk::DDS_LOADER_INVALID_DATA:
+        return "File contains invalid information.";
+    case DDSTextureLoaderVk::DDS_LOADER_UNEXPECTED_EOF:
+        return "Unexpected end of file.";
+    case DDSTextureLoaderVk::DDS_LOADER_UNSUPPORTED_FORMAT:
+        return "The image has unsupported format.";
+    case DDSTextureLoaderVk::DDS_LOADER_UNSUPPORTED_LAYOUT:
+        return "The image has incorrect or unsupported layout.";
+    case DDSTextureLoaderVk::DDS_LOADER_BELOW_LIMITS:
+        return "The image dimensions exceed the given device limits. Note that if you don't pass VkPhysicalDeviceLimits* parameter, the limits are set to minimum possible.";
+    case DDSTextureLoaderVk::DDS_LOADER_NO_HOST_MEMORY:
+        return "Out of system memory.";
+    case DDSTextureLoaderVk::DDS_LOADER_NO_DEVICE_MEMORY:
+        return "Out of video memory.";
+    case DDSTextureLoaderVk::DDS_LOADER_NO_FUNCTION:
+        return "The function vkCreateImage() has not been loaded. Please use SetVkCreateImageFuncPtr() or SetVkCreateImageFuncPtrWithUserPtr()+SetVkCreateImageUserPtr() to pass the function to the loader.";
+    case DDSTextureLoaderVk::DDS_LOADER_ARITHMETIC_OVERFLOW:
+        return "Unexpected arithmetic overflow when reading the file.";
+    default:
+        return "Unknown error code.";
+    }
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromMemory(
+    VkDevice vkDevice,
+    const uint8_t* ddsData,
+    size_t ddsDataSize,
+    VkImage* texture,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    size_t maxsize,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* alphaMode)
+{
+    return LoadDDSTextureFromMemoryEx(
+        vkDevice,
+        ddsData,
+        ddsDataSize,
+        maxsize,
+        nullptr,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        0,
+        DDS_LOADER_DEFAULT,
+        nullptr,
+        texture,
+        subresources,
+        outImageCreateInfo,
+        alphaMode);
+}
+
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromMemoryEx(
+    VkDevice vkDevice,
+    const uint8_t* ddsData,
+    size_t ddsDataSize,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* alphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage,
+    DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget,
+    DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy,
+    const VkImageSubresourceRange* subresourceRange,
+    DDSTextureLoaderVk::TextureDedupCache* dedupCache)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (alphaMode)
+    {
+        *alphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+
+    if(!ddsData || !IsValidTextureOutput(vkDevice, texture, outImageCreateInfo, loadFlags, dedupCache))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // Validate DDS file in memory
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* bitData = nullptr;
+    size_t bitSize = 0;
+
+    DDS_LOADER_RESULT errCode = LoadTextureDataFromMemory(ddsData,
+        ddsDataSize,
+        &header,
+        &bitData,
+        &bitSize
+    );
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    errCode = CreateTextureFromDDS(vkDevice,
+        header, bitData, bitSize, 0, bitSize, maxsize,
+        deviceLimits, usageFlags, createFlags, loadFlags,
+        allocator, texture, subresources, outImageCreateInfo, alphaMode, outStorage, memoryBudget, mipDropPolicy, subresourceRange, dedupCache);
+    if (errCode == DDS_LOADER_SUCCESS)
+    {
+        if (texture && *texture)
+        {
+            SetDebugObjectName(vkDevice, *texture, "DDSTextureLoader");
+        }
+    }
+
+    return errCode;
+}
+
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFile(
+    VkDevice vkDevice,
+    const char_type* fileName,
+    VkImage* texture,
+    std::unique_ptr<uint8_t[]>& ddsData,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    size_t maxsize,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode)
+{
+    return LoadDDSTextureFromFileEx(
+        vkDevice,
+        fileName,
+        maxsize,
+        nullptr,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        0,
+        DDS_LOADER_DEFAULT,
+        nullptr,
+        texture,
+        ddsData,
+        subresources,
+        outImageCreateInfo,
+        outAlphaMode);
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFileEx(
+    VkDevice vkDevice,
+    const char_type* fileName,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    std::unique_ptr<uint8_t[]>& ddsData,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage,
+    DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget,
+    DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy,
+    const VkImageSubresourceRange* subresourceRange,
+    DDSTextureLoaderVk::TextureDedupCache* dedupCache)
+{
+    return LoadDDSTextureFromFileRange(
+        vkDevice,
+        fileName,
+        0,
+        WholeFileDataSize,
+        maxsize,
+        deviceLimits,
+        usageFlags,
+        createFlags,
+        loadFlags,
+        allocator,
+        texture,
+        ddsData,
+        subresources,
+        outImageCreateInfo,
+        outAlphaMode,
+        outStorage,
+        memoryBudget,
+        mipDropPolicy,
+        subresourceRange,
+        dedupCache);
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFileRange(
+    VkDevice vkDevice,
+    const char_type* fileName,
+    uint64_t fileOffset,
+    uint64_t ddsDataSize,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    std::unique_ptr<uint8_t[]>& ddsData,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage,
+    DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget,
+    DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy,
+    const VkImageSubresourceRange* subresourceRange,
+    DDSTextureLoaderVk::TextureDedupCache* dedupCache)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (outAlphaMode)
+    {
+        *outAlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+
+    if (!fileName || !IsValidTextureOutput(vkDevice, texture, outImageCreateInfo, loadFlags, dedupCache))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* bitData = nullptr;
+    size_t bitSize = 0;
+    size_t bitDataOffset = 0;
+    size_t totalBitSize = 0;
+
+    DDS_LOADER_RESULT errCode = DDS_LOADER_SUCCESS;
+    if (subresourceRange)
+    {
+        // Only the selected subresources are read
+        errCode = LoadTextureRangeFromFile(fileName,
+            fileOffset,
+            ddsDataSize,
+            subresourceRange,
+            ddsData,
+            &header,
+            &bitData,
+            &bitSize,
+            &bitDataOffset,
+            &totalBitSize
+        );
+    }
+    else
+    {
+        errCode = LoadTextureDataFromFile(fileName,
+            fileOffset,
+            ddsDataSize,
+            ddsData,
+            &header,
+            &bitData,
+            &bitSize
+        );
+        totalBitSize = bitSize;
+    }
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    errCode = CreateTextureFromDDS(vkDevice,
+        header, bitData, bitSize, bitDataOffset, totalBitSize, maxsize,
+        deviceLimits,
+        usageFlags, createFlags, loadFlags,
+        allocator, texture, subresources, outImageCreateInfo, outAlphaMode, outStorage, memoryBudget, mipDropPolicy, subresourceRange, dedupCache);
+
+    if (errCode == DDS_LOADER_SUCCESS && texture)
+    {
+        #if defined(WIN32) && defined(DDS_LOADER_PATH_WIDE_CHAR)
+            int filenameSize = WideCharToMultiByte(CP_UTF8, 0, fileName, -1, nullptr, 0, nullptr, nullptr);
+
+            char* filenameU8 = (char*)_malloca(filenameSize + 1);
+            WideCharToMultiByte(CP_UTF8, 0, fileName, -1, filenameU8, filenameSize + 1, nullptr, nullptr);
+
+            SetDebugTextureInfo(vkDevice, filenameU8, *texture);
+        #else
+            SetDebugTextureInfo(vkDevice, fileName, *texture);
+        #endif // _WIN32
+    }
+
+    return errCode;
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureArrayFromFiles(
+    VkDevice vkDevice,
+    const char_type* const* fileNames,
+    size_t fileCount,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    std::vector<std::unique_ptr<uint8_t[]>>& ddsData,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* alphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage,
+    size_t* outFailedFileIndex)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (alphaMode)
+    {
+        *alphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+    if (outFailedFileIndex)
+    {
+        *outFailedFileIndex = 0;
+    }
+
+    ddsData.clear();
+    subresources.clear();
+
+    if (!fileNames || fileCount == 0 || !IsValidTextureOutput(vkDevice, texture, outImageCreateInfo, loadFlags, nullptr))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // Every file would be processed on its own and could end up with a different format
+    if (loadFlags & ProcessingLoadFlags)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    std::vector<TextureFile> files;
+    LoadTextureFiles(fileNames, fileCount, ddsData, files);
+
+    const TextureLayout& layout = files[0].Layout;
+
+    VkImageCreateFlags layoutCreateFlags = layout.CreateFlags;
+    size_t             arraySize         = 0;
+    DDS_ALPHA_MODE     arrayAlphaMode    = DDS_ALPHA_MODE_UNKNOWN;
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        const TextureFile& file = files[i];
+
+        DDS_LOADER_RESULT errCode = file.Result;
+        if (errCode == DDS_LOADER_SUCCESS && (file.Layout.ImageType != VK_IMAGE_TYPE_2D || file.Layout.Format != layout.Format
+            || file.Layout.Width != layout.Width || file.Layout.Height != layout.Height || file.Layout.MipCount != layout.MipCount
+            || file.Layout.IsTypeless != layout.IsTypeless))
+        {
+            errCode = DDS_LOADER_UNSUPPORTED_LAYOUT;
+        }
+
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            if (outFailedFileIndex)
+            {
+                *outFailedFileIndex = i;
+            }
+
+            ddsData.clear();
+            return errCode;
+        }
+
+        // The array stays cube compatible only if all files are cubes
+        layoutCreateFlags &= file.Layout.CreateFlags;
+        arraySize += file.Layout.ArraySize;
+
+        const DDS_ALPHA_MODE fileAlphaMode = GetAlphaMode(file.Header);
+        arrayAlphaMode = (i == 0 || fileAlphaMode == arrayAlphaMode) ? fileAlphaMode : DDS_ALPHA_MODE_UNKNOWN;
+    }
+
+    // Same flags as a single file with all the layers
+    if (arraySize > 1)
+    {
+        layoutCreateFlags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
+    }
+
+    VkImageCreateFlags imageCreateFlags = createFlags | layoutCreateFlags;
+    if (loadFlags & DDS_LOADER_SPARSE_RESIDENCY)
+    {
+        imageCreateFlags |= VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+    }
+
+    DDS_LOADER_RESULT errCode = CheckTextureLimits(VK_IMAGE_TYPE_2D, layout.Width, layout.Height, 1, layout.MipCount, arraySize,
+        imageCreateFlags, GetImageLimits(deviceLimits));
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        ddsData.clear();
+        return errCode;
+    }
+
+    const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+    if (numberOfPlanes == 0 || ((numberOfPlanes > 1) && IsDepthStencil(layout.Format)))
+    {
+        ddsData.clear();
+        return DDS_LOADER_UNSUPPORTED_FORMAT;
+    }
+
+    size_t skipMip = 0;
+    size_t twidth  = 0;
+    size_t theight = 0;
+    size_t tdepth  = 0;
+
+    subresources.reserve(arraySize * layout.MipCount * numberOfPlanes);
+
+    std::vector<LoadedSubresourceData> fileSubresources;
+    uint32_t baseLayer = 0;
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        const TextureFile& file = files[i];
+
+        SubresourceRange range;
+        range.MipCount   = file.Layout.MipCount;
+        range.LayerCount = file.Layout.ArraySize;
+
+        errCode = FillInitData(file.Layout.Width, file.Layout.Height, 1, file.Layout.MipCount, file.Layout.ArraySize,
+            numberOfPlanes, file.Layout.Format,
+            maxsize, file.BitSize, file.BitData, 0, file.BitSize, range,
+            twidth, theight, tdepth, skipMip, fileSubresources);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            if (outFailedFileIndex)
+            {
+                *outFailedFileIndex = i;
+            }
+
+            ddsData.clear();
+            subresources.clear();
+            return errCode;
+        }
+
+        for (LoadedSubresourceData& subresource : fileSubresources)
+        {
+            subresource.SubresourceSlice.mipLevel   -= static_cast<uint32_t>(skipMip);
+            subresource.SubresourceSlice.arrayLayer += baseLayer;
+            subresources.push_back(subresource);
+        }
+
+        baseLayer += file.Layout.ArraySize;
+    }
+
+    size_t imageMips = layout.MipCount;
+    if (loadFlags & DDS_LOADER_MIP_RESERVE)
+    {
+        imageMips = std::min<size_t>(maxDirect3DMips, CountMips(layout.Width, layout.Height));
+    }
+
+    errCode = CreateTextureResource(vkDevice, VK_IMAGE_TYPE_2D, twidth, theight, 1, imageMips - skipMip, arraySize,
+        layout.Format, usageFlags, imageCreateFlags, loadFlags, layout.IsTypeless, allocator, texture, outImageCreateInfo, outStorage);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        ddsData.clear();
+        subresources.clear();
+        return errCode;
+    }
+
+    if (alphaMode)
+    {
+        *alphaMode = arrayAlphaMode;
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureAtlasFromFiles(
+    VkDevice vkDevice,
+    const char_type* const* fileNames,
+    size_t fileCount,
+    uint32_t atlasSize,
+    uint32_t paddingTexels,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    std::vector<std::unique_ptr<uint8_t[]>>& ddsData,
+    std::vector<DDSTextureLoaderVk::AtlasTexturePlacement>& outPlacements,
+    std::vector<DDSTextureLoaderVk::TextureAtlas>& outAtlases,
+    size_t* outFailedFileIndex)
+{
+    if (outFailedFileIndex)
+    {
+        *outFailedFileIndex = 0;
+    }
+
+    ddsData.clear();
+    outPlacements.clear();
+    outAtlases.clear();
+
+    if (!fileNames || fileCount == 0 || atlasSize == 0 || (!vkDevice && !(loadFlags & DDS_LOADER_DEFER_CREATION)))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // The textures are copied into the atlases as stored
+    if (loadFlags & (ProcessingLoadFlags | DDS_LOADER_MIP_RESERVE | DDS_LOADER_SPARSE_RESIDENCY))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    std::vector<TextureFile> files;
+    LoadTextureFiles(fileNames, fileCount, ddsData, files);
+
+    const auto failFile = [&](size_t fileIndex, DDS_LOADER_RESULT errCode)
+    {
+        if (outFailedFileIndex)
+        {
+            *outFailedFileIndex = fileIndex;
+        }
+
+        ddsData.clear();
+        outPlacements.clear();
+        outAtlases.clear();
+        return errCode;
+    };
+
+    // The textures of a group share the atlases, so they need the same format
+    struct AtlasGroup
+    {
+        VkFormat            Format        = VK_FORMAT_UNDEFINED;
+        bool                IsTypeless    = false;
+        VkImageCreateFlags  CreateFlags   = 0;
+        uint32_t            BlockWidth    = 1;
+        uint32_t            BlockHeight   = 1;
+        size_t              BytesPerBlock = 0;
+        uint32_t            MipCount      = 0;
+        std::vector<size_t> Files;
+    };
+
+    std::vector<AtlasGroup> groups;
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        const TextureFile& file = files[i];
+        if (file.Result != DDS_LOADER_SUCCESS)
+        {
+            return failFile(i, file.Result);
+        }
+
+        const TextureLayout& layout = file.Layout;
+        if (layout.ImageType != VK_IMAGE_TYPE_2D || layout.ArraySize != 1)
+        {
+            return failFile(i, DDS_LOADER_UNSUPPORTED_LAYOUT);
+        }
+
+        if (GetVkFormatPlaneCount(layout.Format) != 1 || IsDepthStencil(layout.Format))
+        {
+            return failFile(i, DDS_LOADER_UNSUPPORTED_FORMAT);
+        }
+
+        uint32_t blockWidth    = 0;
+        uint32_t blockHeight   = 0;
+        size_t   bytesPerBlock = 0;
+        DDS_LOADER_RESULT errCode = GetBlockExtent(layout.Format, GetPlaneAspect(layout.Format, 1, 0), &blockWidth, &blockHeight, &bytesPerBlock);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return failFile(i, errCode);
+        }
+
+        // Partial blocks can only be copied at the edge of the image
+        if ((layout.Width % blockWidth) != 0 || (layout.Height % blockHeight) != 0)
+        {
+            return failFile(i, DDS_LOADER_UNSUPPORTED_LAYOUT);
+        }
+
+        // The mip levels that are still made of whole blocks
+        uint32_t mipCount = 1;
+        while (mipCount < layout.MipCount && (layout.Width % (blockWidth << mipCount)) == 0 && (layout.Height % (blockHeight << mipCount)) == 0)
+        {
+            mipCount++;
+        }
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&layout](const AtlasGroup& atlasGroup)
+        {
+            return atlasGroup.Format == layout.Format && atlasGroup.IsTypeless == layout.IsTypeless;
+        });
+        if (group == groups.end())
+        {
+            AtlasGroup atlasGroup;
+            atlasGroup.Format        = layout.Format;
+            atlasGroup.IsTypeless    = layout.IsTypeless;
+            atlasGroup.CreateFlags   = layout.CreateFlags;
+            atlasGroup.BlockWidth    = blockWidth;
+            atlasGroup.BlockHeight   = blockHeight;
+            atlasGroup.BytesPerBlock = bytesPerBlock;
+            atlasGroup.MipCount      = mipCount;
+
+            group = groups.insert(groups.end(), std::move(atlasGroup));
+        }
+
+        group->MipCount = std::min(group->MipCount, mipCount);
+        group->Files.push_back(i);
+    }
+
+    const uint32_t maxAtlasSize = std::min(atlasSize, GetImageLimits(deviceLimits).MaxImageDimension2D);
+
+    outPlacements.resize(fileCount);
+
+    std::vector<VkExtent3D>          fileCells(fileCount);
+    std::vector<size_t>              atlasGroups;
+    std::vector<std::vector<size_t>> atlasFiles;
+    std::vector<VkExtent3D>          atlasExtents;
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        AtlasGroup& group = groups[g];
+
+        // Every mip level of every texture must start at a block boundary, so the textures are placed on a grid of
+        // the block size of the last atlas mip level scaled back to mip level 0. The padding is kept at every mip level too
+        const uint32_t cellWidth  = group.BlockWidth  << (group.MipCount - 1);
+        const uint32_t cellHeight = group.BlockHeight << (group.MipCount - 1);
+        const uint32_t padding    = paddingTexels << (group.MipCount - 1);
+        const uint32_t gridWidth  = maxAtlasSize / cellWidth;
+        const uint32_t gridHeight = maxAtlasSize / cellHeight;
+
+        for (size_t fileIndex : group.Files)
+        {
+            const TextureLayout& layout = files[fileIndex].Layout;
+            if ((layout.Width + cellWidth - 1) / cellWidth > gridWidth || (layout.Height + cellHeight - 1) / cellHeight > gridHeight)
+            {
+                return failFile(fileIndex, DDS_LOADER_INVALID_ARG);
+            }
+
+            // No padding is needed past the atlas edge
+            fileCells[fileIndex].width  = std::min((layout.Width  + padding + cellWidth  - 1) / cellWidth,  gridWidth);
+            fileCells[fileIndex].height = std::min((layout.Height + padding + cellHeight - 1) / cellHeight, gridHeight);
+        }
+
+        // Shelf packing, from the tallest textures to the shortest ones
+        std::stable_sort(group.Files.begin(), group.Files.end(), [&fileCells](size_t left, size_t right)
+        {
+            if (fileCells[left].height != fileCells[right].height)
+            {
+                return fileCells[left].height > fileCells[right].height;
+            }
+
+            return fileCells[left].width > fileCells[right].width;
+        });
+
+        bool     isAtlasOpen = false;
+        uint32_t shelfX      = 0;
+        uint32_t shelfY      = 0;
+        uint32_t shelfHeight = 0;
+        for (size_t fileIndex : group.Files)
+        {
+            const VkExtent3D& cells = fileCells[fileIndex];
+            if (isAtlasOpen && shelfX + cells.width > gridWidth)
+            {
+                shelfY      += shelfHeight;
+                shelfX      = 0;
+                shelfHeight = 0;
+            }
+
+            if (!isAtlasOpen || shelfY + cells.height > gridHeight)
+            {
+                atlasGroups.push_back(g);
+                atlasFiles.emplace_back();
+                atlasExtents.push_back({0, 0, 1});
+
+                isAtlasOpen = true;
+                shelfX      = 0;
+                shelfY      = 0;
+                shelfHeight = 0;
+            }
+
+            const TextureLayout& layout = files[fileIndex].Layout;
+
+            AtlasTexturePlacement& placement = outPlacements[fileIndex];
+            placement.AtlasIndex = static_cast<uint32_t>(atlasFiles.size() - 1);
+            placement.Offset     = {static_cast<int32_t>(shelfX * cellWidth), static_cast<int32_t>(shelfY * cellHeight), 0};
+            placement.Extent     = {layout.Width, layout.Height, 1};
+            placement.AlphaMode  = GetAlphaMode(files[fileIndex].Header);
+
+            VkExtent3D& atlasExtent = atlasExtents.back();
+            atlasExtent.width  = std::max(atlasExtent.width,  shelfX * cellWidth  + layout.Width);
+            atlasExtent.height = std::max(atlasExtent.height, shelfY * cellHeight + layout.Height);
+            atlasFiles.back().push_back(fileIndex);
+
+            shelfX     += cells.width;
+            shelfHeight = std::max(shelfHeight, cells.height);
+        }
+
+        for (size_t a = atlasExtents.size(); a > 0 && atlasGroups[a - 1] == g; a--)
+        {
+            // Whole cells, so the mip levels of the atlas keep the texture extents exact
+            VkExtent3D& atlasExtent = atlasExtents[a - 1];
+            atlasExtent.width  = (atlasExtent.width  + cellWidth  - 1) / cellWidth  * cellWidth;
+            atlasExtent.height = (atlasExtent.height + cellHeight - 1) / cellHeight * cellHeight;
+        }
+    }
+
+    outAtlases.resize(atlasFiles.size());
+
+    std::vector<LoadedSubresourceData> fileSubresources;
+    for (size_t a = 0; a < outAtlases.size(); a++)
+    {
+        TextureAtlas&     atlas       = outAtlases[a];
+        const AtlasGroup& group       = groups[atlasGroups[a]];
+        const VkExtent3D& atlasExtent = atlasExtents[a];
+
+        const uint64_t copyAlignment = std::lcm<uint64_t>(4, std::max<size_t>(group.BytesPerBlock, 1));
+        for (size_t fileIndex : atlasFiles[a])
+        {
+            const TextureFile& file = files[fileIndex];
+
+            SubresourceRange range;
+            range.MipCount   = file.Layout.MipCount;
+            range.LayerCount = 1;
+
+            size_t twidth  = 0;
+            size_t theight = 0;
+            size_t tdepth  = 0;
+            size_t skipMip = 0;
+            DDS_LOADER_RESULT errCode = FillInitData(file.Layout.Width, file.Layout.Height, 1, file.Layout.MipCount, 1, 1, file.Layout.Format,
+                0, file.BitSize, file.BitData, 0, file.BitSize, range,
+                twidth, theight, tdepth, skipMip, fileSubresources);
+            if (errCode != DDS_LOADER_SUCCESS)
+            {
+                return failFile(fileIndex, errCode);
+            }
+
+            AtlasTexturePlacement& placement = outPlacements[fileIndex];
+            placement.UvOffset[0] = static_cast<float>(placement.Offset.x) / static_cast<float>(atlasExtent.width);
+            placement.UvOffset[1] = static_cast<float>(placement.Offset.y) / static_cast<float>(atlasExtent.height);
+            placement.UvScale[0]  = static_cast<float>(placement.Extent.width)  / static_cast<float>(atlasExtent.width);
+            placement.UvScale[1]  = static_cast<float>(placement.Extent.height) / static_cast<float>(atlasExtent.height);
+
+            for (const LoadedSubresourceData& subresource : fileSubresources)
+            {
+                const uint32_t mipLevel = subresource.SubresourceSlice.mipLevel;
+                if (mipLevel >= group.MipCount)
+                {
+                    continue;
+                }
+
+                VkBufferImageCopy region;
+                region.bufferOffset                    = atlas.StagingByteSize + (copyAlignment - atlas.StagingByteSize % copyAlignment) % copyAlignment;
+                region.bufferRowLength                 = 0;
+                region.bufferImageHeight               = 0;
+                region.imageSubresource.aspectMask     = subresource.SubresourceSlice.aspectMask;
+                region.imageSubresource.mipLevel       = mipLevel;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount     = 1;
+                region.imageOffset                     = {placement.Offset.x >> mipLevel, placement.Offset.y >> mipLevel, 0};
+                region.imageExtent                     = subresource.Extent;
+
+                atlas.StagingByteSize = region.bufferOffset + subresource.DataByteSize;
+                atlas.Subresources.push_back(subresource);
+                atlas.CopyRegions.push_back(region);
+            }
+        }
+    }
+
+    // The images are created last, so that only their creation can fail once the first one exists
+    for (size_t a = 0; a < outAtlases.size(); a++)
+    {
+        TextureAtlas&     atlas = outAtlases[a];
+        const AtlasGroup& group = groups[atlasGroups[a]];
+
+        DDS_LOADER_RESULT errCode = CreateTextureResource(vkDevice, VK_IMAGE_TYPE_2D, atlasExtents[a].width, atlasExtents[a].height, 1, group.MipCount, 1,
+            group.Format, usageFlags, createFlags | group.CreateFlags, loadFlags, group.IsTypeless, allocator, &atlas.Image, &atlas.ImageCreateInfo, &atlas.Storage);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            // The images created so far stay in outAtlases for the application to destroy
+            outAtlases.resize(a);
+            return errCode;
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFileProgressive(
+    VkDevice vkDevice,
+    const char_type* fileName,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    DDSTextureLoaderVk::PFN_DdsLoader_MipLoadedCallback mipLoadedCallback,
+    void* callbackUserData,
+    bool callbackPerSubresource,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (outAlphaMode)
+    {
+        *outAlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+
+    if (!vkDevice || !fileName || !texture || !mipLoadedCallback || (loadFlags & DDS_LOADER_DEFER_CREATION))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+    const DDS_HEADER* header = nullptr;
+    uint64_t bitDataOffset = 0;
+    uint64_t bitSize = 0;
+
+    DDS_LOADER_RESULT errCode = LoadTextureHeaderFromFile(fileName, 0, WholeFileDataSize, headerData, &header, &bitDataOffset, &bitSize);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // The file offsets and sizes of the subresources, in the file order (plane, array layer, mip level)
+    std::vector<LoadedSubresourceData> fileSubresources;
+    std::vector<uint64_t>              fileOffsets;
+    size_t                             skipMip = 0;
+
+    // Allocate the buffer and open the file before the image is created, so that these failures don't return an image
+    TextureLayout layout;
+    errCode = GetTextureLayout(header, layout);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+    if (numberOfPlanes == 0)
+    {
+        return DDS_LOADER_UNSUPPORTED_FORMAT;
+    }
+
+    errCode = GetDataSubresources(layout, numberOfPlanes, maxsize, bitDataOffset, bitSize, fileSubresources, fileOffsets, skipMip);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // A single buffer fits the largest mip level of all planes and layers, every smaller mip reuses it.
+    // The image creation may only drop more mips, so this stays the largest one
+    std::vector<size_t> mipByteSizes(layout.MipCount);
+    for (const LoadedSubresourceData& subresource : fileSubresources)
+    {
+        mipByteSizes[subresource.SubresourceSlice.mipLevel] += subresource.DataByteSize;
+    }
+
+    const size_t maxMipByteSize = *std::max_element(mipByteSizes.begin(), mipByteSizes.end());
+
+    std::unique_ptr<uint8_t[]> mipData(new (std::nothrow) uint8_t[maxMipByteSize]);
+    if (!mipData)
+    {
+        return DDS_LOADER_NO_HOST_MEMORY;
+    }
+
+    std::ifstream inFile(std::filesystem::path(fileName), std::ios::in | std::ios::binary);
+    if (!inFile)
+        return DDS_LOADER_FAIL;
+
+    errCode = CreateTextureFromHeader(vkDevice, header, bitDataOffset, bitSize, maxsize, deviceLimits,
+        usageFlags, createFlags, loadFlags, allocator, texture, outImageCreateInfo, outStorage, fileSubresources, fileOffsets, skipMip);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    const size_t mipCount = fileSubresources.back().SubresourceSlice.mipLevel + size_t(1);
+
+    if (outAlphaMode)
+    {
+        *outAlphaMode = GetAlphaMode(header);
+    }
+
+    #if defined(WIN32) && defined(DDS_LOADER_PATH_WIDE_CHAR)
+        int filenameSize = WideCharToMultiByte(CP_UTF8, 0, fileName, -1, nullptr, 0, nullptr, nullptr);
+
+        char* filenameU8 = (char*)_malloca(filenameSize + 1);
+        WideCharToMultiByte(CP_UTF8, 0, fileName, -1, filenameU8, filenameSize + 1, nullptr, nullptr);
+
+        SetDebugTextureInfo(vkDevice, filenameU8, *texture);
+    #else
+        SetDebugTextureInfo(vkDevice, fileName, *texture);
+    #endif // _WIN32
+
+    std::vector<LoadedSubresourceData> mipSubresources;
+    for (size_t i = mipCount; i-- > skipMip;)
+    {
+        mipSubresources.clear();
+
+        uint8_t* dstData = mipData.get();
+        for (size_t k = 0; k < fileSubresources.size(); k++)
+        {
+            if (fileSubresources[k].SubresourceSlice.mipLevel != i)
+            {
+                continue;
+            }
+
+            LoadedSubresourceData subresource = fileSubresources[k];
+            subresource.PData                     = dstData;
+            subresource.SubresourceSlice.mipLevel = static_cast<uint32_t>(i - skipMip);
+
+            inFile.seekg(std::streamoff(fileOffsets[k]), std::ios::beg);
+            if (!ReadFileData(inFile, dstData, subresource.DataByteSize))
+                return DDS_LOADER_UNEXPECTED_EOF;
+
+            dstData += subresource.DataByteSize;
+
+            if (callbackPerSubresource)
+            {
+                if (!mipLoadedCallback(callbackUserData, &subresource, 1))
+                {
+                    return DDS_LOADER_SUCCESS;
+                }
+            }
+            else
+            {
+                mipSubresources.push_back(subresource);
+            }
+        }
+
+        if (!callbackPerSubresource && !mipLoadedCallback(callbackUserData, mipSubresources.data(), mipSubresources.size()))
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromReader(
+    VkDevice vkDevice,
+    DDSTextureLoaderVk::PFN_DdsLoader_ReadCallback readCallback,
+    void* readUserData,
+    uint64_t ddsDataSize,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    DDSTextureLoaderVk::PFN_DdsLoader_SubresourceDestinationCallback destinationCallback,
+    void* destinationUserData,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (outAlphaMode)
+    {
+        *outAlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+
+    if (!vkDevice || !readCallback || !texture || !destinationCallback || (loadFlags & DDS_LOADER_DEFER_CREATION))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // Only the headers are kept in host memory, the subresource data goes straight to the destinations
+    alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+    const size_t headerSize = size_t(std::min<uint64_t>(ddsDataSize, MaxDDSHeaderSize));
+    if (!readCallback(readUserData, 0, headerSize, headerData))
+    {
+        return DDS_LOADER_FAIL;
+    }
+
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* bitData = nullptr;
+    size_t headerBitSize = 0;
+    DDS_LOADER_RESULT errCode = LoadTextureDataFromMemory(headerData, headerSize, &header, &bitData, &headerBitSize);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    const uint64_t bitDataOffset = uint64_t(bitData - headerData);
+
+    std::vector<LoadedSubresourceData> dataSubresources;
+    std::vector<uint64_t>              dataOffsets;
+    size_t                             skipMip = 0;
+
+    errCode = CreateTextureFromHeader(vkDevice, header, bitDataOffset, ddsDataSize - bitDataOffset, maxsize, deviceLimits,
+        usageFlags, createFlags, loadFlags, allocator, texture, outImageCreateInfo, outStorage, dataSubresources, dataOffsets, skipMip);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    if (outAlphaMode)
+    {
+        *outAlphaMode = GetAlphaMode(header);
+    }
+
+    SetDebugObjectName(vkDevice, *texture, "DDSTextureLoader");
+
+    // The data order, so a sequential reader never seeks back
+    for (size_t k = 0; k < dataSubresources.size(); k++)
+    {
+        LoadedSubresourceData subresource = dataSubresources[k];
+        subresource.SubresourceSlice.mipLevel -= static_cast<uint32_t>(skipMip);
+
+        void* dstData = destinationCallback(destinationUserData, &subresource);
+        if (!dstData)
+        {
+            return DDS_LOADER_SUCCESS;
+        }
+
+        if (!readCallback(readUserData, dataOffsets[k], subresource.DataByteSize, dstData))
+        {
+            return DDS_LOADER_UNEXPECTED_EOF;
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::ReloadDDSTextureFromFile(
+    VkDevice vkDevice,
+    const char_type* fileName,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    DDSTextureLoaderVk::TextureReloadState& state,
+    std::unique_ptr<uint8_t[]>& ddsData,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& changedSubresources,
+    VkImage* outRetiredImage)
+{
+    if (outRetiredImage)
+    {
+        *outRetiredImage = VK_NULL_HANDLE;
+    }
+
+    changedSubresources.clear();
+
+    // The previous image could be replaced, it would leak without outRetiredImage
+    if (!vkDevice || !fileName || (loadFlags & DDS_LOADER_DEFER_CREATION) || (state.Image != VK_NULL_HANDLE && !outRetiredImage))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* bitData = nullptr;
+    size_t bitSize = 0;
+
+    DDS_LOADER_RESULT errCode = LoadTextureDataFromFile(fileName, 0, WholeFileDataSize, ddsData, &header, &bitData, &bitSize);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // Same headers and parameters give the same image and the same subresource layout
+    const uint64_t headerHash = GetTextureDedupKey(header, nullptr, 0, 0, bitSize, maxsize, deviceLimits, usageFlags, createFlags, loadFlags, nullptr);
+    bool isImageReused = state.Image != VK_NULL_HANDLE && headerHash == state.HeaderHash;
+
+    std::vector<LoadedSubresourceData> dataSubresources;
+    std::vector<uint64_t>              dataOffsets;
+    size_t                             skipMip = 0;
+
+    VkImage           image           = VK_NULL_HANDLE;
+    VkImageCreateInfo imageCreateInfo = {};
+    if (isImageReused)
+    {
+        TextureLayout layout;
+        errCode = GetTextureLayout(header, layout);
+        if (errCode == DDS_LOADER_SUCCESS)
+        {
+            errCode = GetDataSubresources(layout, GetVkFormatPlaneCount(layout.Format), maxsize, 0, bitSize, dataSubresources, dataOffsets, skipMip);
+        }
+
+        // Upload everything if the previous hashes don't match the layout for whatever reason
+        isImageReused = state.SubresourceHashes.size() == dataSubresources.size();
+    }
+    else
+    {
+        errCode = CreateTextureFromHeader(vkDevice, header, 0, bitSize, maxsize, deviceLimits,
+            usageFlags, createFlags, loadFlags, allocator, &image, &imageCreateInfo, nullptr, dataSubresources, dataOffsets, skipMip);
+    }
+
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    std::vector<uint64_t> subresourceHashes(dataSubresources.size());
+    ParallelFor(dataSubresources.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t k = begin; k < end; k++)
+        {
+            subresourceHashes[k] = HashXXH64(bitData + dataOffsets[k], dataSubresources[k].DataByteSize, 0);
+        }
+    });
+
+    for (size_t k = 0; k < dataSubresources.size(); k++)
+    {
+        if (isImageReused && subresourceHashes[k] == state.SubresourceHashes[k])
+        {
+            continue;
+        }
+
+        LoadedSubresourceData subresource = dataSubresources[k];
+        subresource.PData                      = bitData + dataOffsets[k];
+        subresource.SubresourceSlice.mipLevel -= static_cast<uint32_t>(skipMip);
+        changedSubresources.push_back(subresource);
+    }
+
+    if (image != VK_NULL_HANDLE)
+    {
+        SetDebugObjectName(vkDevice, image, "DDSTextureLoader");
+
+        if (outRetiredImage)
+        {
+            *outRetiredImage = state.Image;
+        }
+
+        state.Image           = image;
+        state.ImageCreateInfo = imageCreateInfo;
+        state.HeaderHash      = headerHash;
+    }
+
+    state.SubresourceHashes = std::move(subresourceHashes);
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+#ifdef VK_KHR_maintenance4
+DDS_LOADER_RESULT DDSTextureLoaderVk::PlanImageMemory(
+    VkDevice vkDevice,
+    PFN_vkGetDeviceImageMemoryRequirementsKHR getDeviceImageMemoryRequirements,
+    const VkPhysicalDeviceMemoryProperties& memoryProperties,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkMemoryPropertyFlags memoryPropertyFlags,
+    VkDeviceSize blockByteSize,
+    const VkImageCreateInfo* imageCreateInfos,
+    size_t imageCount,
+    DDSTextureLoaderVk::ImageMemoryPlan& outPlan)
+{
+    outPlan.Images.clear();
+    outPlan.Blocks.clear();
+
+    if (!vkDevice || (imageCount && !imageCreateInfos))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    if (!getDeviceImageMemoryRequirements)
+    {
+        return DDS_LOADER_NO_FUNCTION;
+    }
+
+    outPlan.Images.resize(imageCount);
+
+    std::vector<uint32_t> memoryTypes(imageCount);
+    std::vector<bool>     dedicatedImages(imageCount);
+    for (size_t i = 0; i < imageCount; i++)
+    {
+        // Sparse images are bound page by page, not placed in a block
+        if (imageCreateInfos[i].flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT)
+        {
+            outPlan.Images.clear();
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        VkDeviceImageMemoryRequirementsKHR requirementsInfo;
+        requirementsInfo.sType       = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS_KHR;
+        requirementsInfo.pNext       = nullptr;
+        requirementsInfo.pCreateInfo = &imageCreateInfos[i];
+        requirementsInfo.planeAspect = static_cast<VkImageAspectFlagBits>(0);
+
+        VkMemoryDedicatedRequirements dedicatedRequirements;
+        dedicatedRequirements.sType                       = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+        dedicatedRequirements.pNext                       = nullptr;
+        dedicatedRequirements.prefersDedicatedAllocation  = VK_FALSE;
+        dedicatedRequirements.requiresDedicatedAllocation = VK_FALSE;
+
+        VkMemoryRequirements2KHR memoryRequirements;
+        memoryRequirements.sType              = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR;
+        memoryRequirements.pNext              = &dedicatedRequirements;
+        memoryRequirements.memoryRequirements = {};
+
+        getDeviceImageMemoryRequirements(vkDevice, &requirementsInfo, &memoryRequirements);
+
+        // The first memory type with the requested properties, the types are ordered by the driver from the best performing one
+        const uint32_t memoryTypeBits = memoryRequirements.memoryRequirements.memoryTypeBits;
+        uint32_t memoryType = 0;
+        while (memoryType < memoryProperties.memoryTypeCount
+            && (!(memoryTypeBits & (1u << memoryType)) || (memoryProperties.memoryTypes[memoryType].propertyFlags & memoryPropertyFlags) != memoryPropertyFlags))
+        {
+            memoryType++;
+        }
+
+        if (memoryType == memoryProperties.memoryTypeCount)
+        {
+            outPlan.Images.clear();
+            return DDS_LOADER_NO_DEVICE_MEMORY;
+        }
+
+        outPlan.Images[i].MemoryRequirements = memoryRequirements.memoryRequirements;
+        memoryTypes[i]     = memoryType;
+        dedicatedImages[i] = dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation;
+    }
+
+    // Place the largest alignments first, so that little memory is lost to the padding
+    std::vector<size_t> imageOrder(imageCount);
+    std::iota(imageOrder.begin(), imageOrder.end(), size_t(0));
+    std::stable_sort(imageOrder.begin(), imageOrder.end(), [&outPlan](size_t left, size_t right)
+    {
+        const VkMemoryRequirements& leftRequirements  = outPlan.Images[left].MemoryRequirements;
+        const VkMemoryRequirements& rightRequirements = outPlan.Images[right].MemoryRequirements;
+        if (leftRequirements.alignment != rightRequirements.alignment)
+        {
+            return leftRequirements.alignment > rightRequirements.alignment;
+        }
+
+        return leftRequirements.size > rightRequirements.size;
+    });
+
+    // Linear and optimal images are never placed in the same block, so bufferImageGranularity only pads the end
+    // of the blocks, for the application to place buffers after the images
+    std::vector<bool> linearBlocks;
+    for (size_t i : imageOrder)
+    {
+        PlannedImageMemory& image     = outPlan.Images[i];
+        const VkDeviceSize  imageSize = image.MemoryRequirements.size;
+        const VkDeviceSize  alignment = std::max<VkDeviceSize>(image.MemoryRequirements.alignment, 1);
+        const bool          isLinear  = imageCreateInfos[i].tiling == VK_IMAGE_TILING_LINEAR;
+
+        // First fit into the blocks of the same memory type
+        size_t blockIndex = outPlan.Blocks.size();
+        VkDeviceSize offset = 0;
+        if (!dedicatedImages[i])
+        {
+            for (size_t k = 0; k < outPlan.Blocks.size(); k++)
+            {
+                const PlannedMemoryBlock& block = outPlan.Blocks[k];
+                if (block.IsDedicated || block.MemoryTypeIndex != memoryTypes[i] || linearBlocks[k] != isLinear)
+                {
+                    continue;
+                }
+
+                const VkDeviceSize alignedOffset = block.ByteSize + (alignment - block.ByteSize % alignment) % alignment;
+                if (!blockByteSize || alignedOffset + imageSize <= blockByteSize)
+                {
+                    blockIndex = k;
+                    offset     = alignedOffset;
+                    break;
+                }
+            }
+        }
+
+        if (blockIndex == outPlan.Blocks.size())
+        {
+            PlannedMemoryBlock block;
+            block.MemoryTypeIndex = memoryTypes[i];
+            block.IsDedicated     = dedicatedImages[i];
+
+            outPlan.Blocks.push_back(block);
+            linearBlocks.push_back(isLinear);
+        }
+
+        image.BlockIndex = static_cast<uint32_t>(blockIndex);
+        image.Offset     = offset;
+        outPlan.Blocks[blockIndex].ByteSize = offset + imageSize;
+    }
+
+    const VkDeviceSize granularity = deviceLimits ? std::max<VkDeviceSize>(deviceLimits->bufferImageGranularity, 1) : 1;
+    for (PlannedMemoryBlock& block : outPlan.Blocks)
+    {
+        if (!block.IsDedicated)
+        {
+            block.ByteSize += (granularity - block.ByteSize % granularity) % granularity;
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+#endif
+
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::GetSparseSubresourceLayout(
+    VkFormat format,
+    const VkSparseImageFormatProperties& formatProperties,
+    const std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    DDSTextureLoaderVk::LoadedSparseLayout& outLayout)
+{
+    outLayout.Tiles.clear();
+    outLayout.MipTail.clear();
+    outLayout.MipTailFirstLod = 0;
+
+    const VkExtent3D granularity = formatProperties.imageGranularity;
+    if (subresources.empty() || !granularity.width || !granularity.height || !granularity.depth)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // Sparse multi-planar images are bound per plane with different tile sizes, which isn't supported
+    if (GetVkFormatPlaneCount(format) != 1)
+    {
+        return DDS_LOADER_UNSUPPORTED_FORMAT;
+    }
+
+    const VkImageAspectFlags aspect = GetPlaneAspect(format, 1, 0);
+
+    uint32_t blockWidth    = 0;
+    uint32_t blockHeight   = 0;
+    size_t   bytesPerBlock = 0;
+    DDS_LOADER_RESULT errCode = GetBlockExtent(format, aspect, &blockWidth, &blockHeight, &bytesPerBlock);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    if ((granularity.width % blockWidth) || (granularity.height % blockHeight))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // The subresources may carry the file mip levels and array layers, the image ones start from the first given mip and layer
+    uint32_t firstFileMip   = UINT32_MAX;
+    uint32_t lastFileMip    = 0;
+    uint32_t firstFileLayer = UINT32_MAX;
+    for (const LoadedSubresourceData& subresource : subresources)
+    {
+        firstFileMip   = std::min(firstFileMip, subresource.SubresourceSlice.mipLevel);
+        lastFileMip    = std::max(lastFileMip, subresource.SubresourceSlice.mipLevel);
+        firstFileLayer = std::min(firstFileLayer, subresource.SubresourceSlice.arrayLayer);
+    }
+
+    // The mip tail starts at the first mip smaller than a tile, or not a multiple of the tile size with the aligned mip size flag
+    const bool isAlignedMipSize = (formatProperties.flags & VK_SPARSE_IMAGE_FORMAT_ALIGNED_MIP_SIZE_BIT) != 0;
+    outLayout.MipTailFirstLod = lastFileMip - firstFileMip + 1;
+    for (const LoadedSubresourceData& subresource : subresources)
+    {
+        const VkExtent3D& extent = subresource.Extent;
+
+        bool isInMipTail = extent.width < granularity.width || extent.height < granularity.height || extent.depth < granularity.depth;
+        if (isAlignedMipSize)
+        {
+            isInMipTail = isInMipTail || (extent.width % granularity.width) || (extent.height % granularity.height) || (extent.depth % granularity.depth);
+        }
+
+        if (isInMipTail)
+        {
+            outLayout.MipTailFirstLod = std::min(outLayout.MipTailFirstLod, subresource.SubresourceSlice.mipLevel - firstFileMip);
+        }
+    }
+
+    for (const LoadedSubresourceData& subresource : subresources)
+    {
+        const uint32_t imageMip = subresource.SubresourceSlice.mipLevel - firstFileMip;
+        if (imageMip >= outLayout.MipTailFirstLod)
+        {
+            LoadedSubresourceData mipTailSubresource = subresource;
+            mipTailSubresource.SubresourceSlice.mipLevel   = imageMip;
+            mipTailSubresource.SubresourceSlice.arrayLayer = subresource.SubresourceSlice.arrayLayer - firstFileLayer;
+
+            outLayout.MipTail.push_back(mipTailSubresource);
+            continue;
+        }
+
+        const VkExtent3D& extent = subresource.Extent;
+
+        size_t rowBytes   = 0;
+        size_t sliceBytes = 0;
+        errCode = GetSurfaceInfo(extent.width, extent.height, format, aspect, &sliceBytes, &rowBytes, nullptr);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        LoadedSparseTile tile;
+        tile.RowLength        = (extent.width  + blockWidth  - 1) / blockWidth  * blockWidth;
+        tile.ImageHeight      = (extent.height + blockHeight - 1) / blockHeight * blockHeight;
+        tile.SubresourceSlice = subresource.SubresourceSlice;
+        tile.SubresourceSlice.mipLevel   = imageMip;
+        tile.SubresourceSlice.arrayLayer = subresource.SubresourceSlice.arrayLayer - firstFileLayer;
+
+        for (uint32_t z = 0; z < extent.depth; z += granularity.depth)
+        {
+            for (uint32_t y = 0; y < extent.height; y += granularity.height)
+            {
+                for (uint32_t x = 0; x < extent.width; x += granularity.width)
+                {
+                    tile.PData = subresource.PData + size_t(z) * sliceBytes + size_t(y / blockHeight) * rowBytes + size_t(x / blockWidth) * bytesPerBlock;
+
+                    tile.Offset = {int32_t(x), int32_t(y), int32_t(z)};
+                    tile.Extent = {std::min(granularity.width,  extent.width  - x),
+                                   std::min(granularity.height, extent.height - y),
+                                   std::min(granularity.depth,  extent.depth  - z)};
+
+                    outLayout.Tiles.push_back(tile);
+                }
+            }
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+// Mip residency manager
+//--------------------------------------------------------------------------------------
+DDSTextureLoaderVk::MipResidencyManager::MipResidencyManager(VkDevice vkDevice,
+    size_t budgetByteSize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    const VkAllocationCallbacks* allocationCallbacks)
+    : Device(vkDevice)
+    , BudgetByteSize(budgetByteSize)
+    , UsedByteSize(0)
+    , DeviceLimits()
+    , HasDeviceLimits(deviceLimits != nullptr)
+    , UsageFlags(usageFlags | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) // Needed for the mip copies and the uploads
+    , CreateFlags(createFlags)
+    , LoadFlags(loadFlags)
+    , AllocationCallbacks(allocationCallbacks)
+    , NextTextureId(1)
+{
+    if (deviceLimits)
+    {
+        DeviceLimits = *deviceLimits;
+    }
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::MipResidencyManager::AddTexture(const char_type* fileName,
+    uint32_t minResidentMips,
+    uint32_t priority,
+    ResidentTextureId* outTextureId,
+    ResidencyUpdate& outUpdate)
+{
+    if (outTextureId)
+    {
+        *outTextureId = 0;
+    }
+
+    if (!Device || !fileName || !outTextureId || (LoadFlags & DDS_LOADER_DEFER_CREATION))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // The mip levels are copied between the images as stored in the file, the images are never sparse
+    if (LoadFlags & (ProcessingLoadFlags | DDS_LOADER_MIP_RESERVE | DDS_LOADER_SPARSE_RESIDENCY))
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+    const DDS_HEADER* header = nullptr;
+    uint64_t bitDataOffset = 0;
+    uint64_t bitSize = 0;
+
+    DDS_LOADER_RESULT errCode = LoadTextureHeaderFromFile(fileName, 0, WholeFileDataSize, headerData, &header, &bitDataOffset, &bitSize);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    TextureLayout layout;
+    errCode = GetTextureLayout(header, layout);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // The mip levels are streamed as stored, multi-planar images would need per-plane copies
+    if (GetVkFormatPlaneCount(layout.Format) != 1)
+    {
+        return DDS_LOADER_UNSUPPORTED_FORMAT;
+    }
+
+    // The image with all mip levels resident has the file size
+    errCode = CheckTextureLimits(layout.ImageType, layout.Width, layout.Height, layout.Depth, layout.MipCount, layout.ArraySize,
+        CreateFlags | layout.CreateFlags, GetImageLimits(HasDeviceLimits ? &DeviceLimits : nullptr));
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    ResidentTexture texture;
+    texture.FileName      = fileName;
+    texture.BitDataOffset = bitDataOffset;
+    texture.ImageType     = layout.ImageType;
+    texture.Format        = layout.Format;
+    texture.Extent        = {layout.Width, layout.Height, layout.Depth};
+    texture.MipCount      = static_cast<uint32_t>(layout.MipCount);
+    texture.ArraySize     = layout.ArraySize;
+    texture.CreateFlags   = CreateFlags | layout.CreateFlags;
+    texture.IsTypeless    = layout.IsTypeless;
+    texture.Priority      = priority;
+
+    const VkImageAspectFlags aspect = GetPlaneAspect(texture.Format, 1, 0);
+    for (uint32_t i = 0; i < texture.MipCount; i++)
+    {
+        const size_t w = std::max<size_t>(texture.Extent.width  >> i, 1);
+        const size_t h = std::max<size_t>(texture.Extent.height >> i, 1);
+        const size_t d = std::max<size_t>(texture.Extent.depth  >> i, 1);
+
+        size_t NumBytes = 0;
+        errCode = GetSurfaceInfo(w, h, texture.Format, aspect, &NumBytes, nullptr, nullptr);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        texture.MipByteSizes.push_back(NumBytes * d);
+        texture.LayerByteSize += NumBytes * d;
+    }
+
+    if (uint64_t(texture.LayerByteSize) * texture.ArraySize > bitSize)
+    {
+        return DDS_LOADER_UNEXPECTED_EOF;
+    }
+
+    texture.MinResidentMips   = std::min(std::max<uint32_t>(minResidentMips, 1), texture.MipCount);
+    texture.FirstResidentMip  = texture.MipCount; // Nothing is resident yet
+    texture.RequestedFirstMip = texture.MipCount - texture.MinResidentMips;
+
+    const ResidentTextureId textureId = NextTextureId;
+    errCode = Recreate(textureId, texture, texture.RequestedFirstMip, outUpdate);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    NextTextureId++;
+    Textures.emplace(textureId, std::move(texture));
+
+    *outTextureId = textureId;
+    return DDS_LOADER_SUCCESS;
+}
+
+VkImage DDSTextureLoaderVk::MipResidencyManager::RemoveTexture(ResidentTextureId textureId)
+{
+    auto it = Textures.find(textureId);
+    if (it == Textures.end())
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    VkImage image = it->second.Image;
+    UsedByteSize -= GetResidentByteSize(it->second, it->second.FirstResidentMip);
+
+    Textures.erase(it);
+    return image;
+}
+
+void DDSTextureLoaderVk::MipResidencyManager::ReportUsage(ResidentTextureId textureId, uint64_t frameIndex, uint32_t finestMip, uint32_t priority)
+{
+    std::lock_guard<std::mutex> lock(UsageMutex);
+    PendingUsage.push_back({textureId, frameIndex, finestMip, priority});
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::MipResidencyManager::Update(std::vector<ResidencyUpdate>& outUpdates, size_t maxUpgradeCount)
+{
+    outUpdates.clear();
+
+    std::vector<TextureUsage> usages;
+    {
+        std::lock_guard<std::mutex> lock(UsageMutex);
+        usages.swap(PendingUsage);
+    }
+
+    for (const TextureUsage& usage : usages)
+    {
+        auto it = Textures.find(usage.TextureId);
+        if (it == Textures.end())
+        {
+            continue;
+        }
+
+        ResidentTexture& texture = it->second;
+
+        // The finest mip of the latest frame wins
+        const uint32_t requestedFirstMip = std::min(usage.FinestMip, texture.MipCount - texture.MinResidentMips);
+        if (usage.FrameIndex > texture.LastUsedFrame)
+        {
+            texture.LastUsedFrame     = usage.FrameIndex;
+            texture.RequestedFirstMip = requestedFirstMip;
+            texture.Priority          = usage.Priority;
+        }
+        else if (usage.FrameIndex == texture.LastUsedFrame)
+        {
+            texture.RequestedFirstMip = std::min(texture.RequestedFirstMip, requestedFirstMip);
+            texture.Priority          = usage.Priority;
+        }
+    }
+
+    // The eviction order: least important first, least recently used first among the equally important
+    std::vector<std::pair<ResidentTextureId, ResidentTexture*>> evictionOrder;
+    std::unordered_map<ResidentTextureId, uint32_t> targetFirstMips;
+    for (auto& entry : Textures)
+    {
+        evictionOrder.emplace_back(entry.first, &entry.second);
+        targetFirstMips[entry.first] = entry.second.FirstResidentMip;
+    }
+
+    auto isLessImportant = [](const ResidentTexture* left, const ResidentTexture* right)
+    {
+        if (left->Priority != right->Priority)
+        {
+            return left->Priority < right->Priority;
+        }
+
+        return left->LastUsedFrame < right->LastUsedFrame;
+    };
+
+    std::sort(evictionOrder.begin(), evictionOrder.end(), [&](const auto& left, const auto& right)
+    {
+        return isLessImportant(left.second, right.second);
+    });
+
+    size_t targetByteSize = UsedByteSize;
+
+    // Drops the top mip of the first texture in eviction order that can give it up.
+    // The mips not requested anymore go first, then the mips of the textures less important than the keptTexture
+    auto evictMip = [&](const ResidentTexture* keptTexture)
+    {
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (auto& entry : evictionOrder)
+            {
+                ResidentTexture* texture = entry.second;
+                uint32_t& targetFirstMip = targetFirstMips[entry.first];
+
+                if (texture == keptTexture || targetFirstMip + texture->MinResidentMips >= texture->MipCount)
+                {
+                    continue;
+                }
+
+                const bool isUnrequested = targetFirstMip < texture->RequestedFirstMip;
+                if ((pass == 0 && !isUnrequested) ||
+                    (pass == 1 && keptTexture && !isLessImportant(texture, keptTexture)))
+                {
+                    continue;
+                }
+
+                targetByteSize -= texture->MipByteSizes[targetFirstMip] * texture->ArraySize;
+                targetFirstMip++;
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    // Fit into the budget first, it may have been lowered
+    while (targetByteSize > BudgetByteSize && evictMip(nullptr))
+    {
+    }
+
+    // Upgrade the most important textures, making room for them if needed
+    size_t upgradeCount = 0;
+    for (auto it = evictionOrder.rbegin(); it != evictionOrder.rend() && upgradeCount < maxUpgradeCount; ++it)
+    {
+        ResidentTexture* texture = it->second;
+        uint32_t& targetFirstMip = targetFirstMips[it->first];
+
+        const uint32_t upgradeFromMip = targetFirstMip;
+        while (targetFirstMip > texture->RequestedFirstMip)
+        {
+            const size_t mipByteSize = texture->MipByteSizes[targetFirstMip - 1] * texture->ArraySize;
+            while (targetByteSize + mipByteSize > BudgetByteSize && evictMip(texture))
+            {
+            }
+
+            if (targetByteSize + mipByteSize > BudgetByteSize)
+            {
+                break;
+            }
+
+            targetByteSize += mipByteSize;
+            targetFirstMip--;
+        }
+
+        if (targetFirstMip != upgradeFromMip)
+        {
+            upgradeCount++;
+        }
+    }
+
+    // Downgrades go first, so the memory they free is available for the upgrades
+    std::stable_sort(evictionOrder.begin(), evictionOrder.end(), [&](const auto& left, const auto& right)
+    {
+        const bool isLeftDowngrade  = targetFirstMips[left.first] > left.second->FirstResidentMip;
+        const bool isRightDowngrade = targetFirstMips[right.first] > right.second->FirstResidentMip;
+        return isLeftDowngrade && !isRightDowngrade;
+    });
+
+    for (auto& entry : evictionOrder)
+    {
+        const uint32_t targetFirstMip = targetFirstMips[entry.first];
+        if (targetFirstMip == entry.second->FirstResidentMip)
+        {
+            continue;
+        }
+
+        ResidencyUpdate update;
+        DDS_LOADER_RESULT errCode = Recreate(entry.first, *entry.second, targetFirstMip, update);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            // The updates made so far are valid and have to be applied
+            return errCode;
+        }
+
+        outUpdates.push_back(std::move(update));
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+void DDSTextureLoaderVk::MipResidencyManager::SetBudgetByteSize(size_t budgetByteSize)
+{
+    BudgetByteSize = budgetByteSize;
+}
+
+size_t DDSTextureLoaderVk::MipResidencyManager::GetBudgetByteSize() const
+{
+    return BudgetByteSize;
+}
+
+size_t DDSTextureLoaderVk::MipResidencyManager::GetUsedByteSize() const
+{
+    return UsedByteSize;
+}
+
+VkImage DDSTextureLoaderVk::MipResidencyManager::GetImage(ResidentTextureId textureId) const
+{
+    auto it = Textures.find(textureId);
+    return it != Textures.end() ? it->second.Image : VK_NULL_HANDLE;
+}
+
+uint32_t DDSTextureLoaderVk::MipResidencyManager::GetFirstResidentMip(ResidentTextureId textureId) const
+{
+    auto it = Textures.find(textureId);
+    return it != Textures.end() ? it->second.FirstResidentMip : 0;
+}
+
+size_t DDSTextureLoaderVk::MipResidencyManager::GetResidentByteSize(const ResidentTexture& texture, uint32_t firstMip) const
+{
+    size_t byteSize = 0;
+    for (uint32_t i = firstMip; i < texture.MipCount; i++)
+    {
+        byteSize += texture.MipByteSizes[i];
+    }
+
+    return byteSize * texture.ArraySize;
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::MipResidencyManager::Recreate(ResidentTextureId textureId, ResidentTexture& texture, uint32_t firstMip, ResidencyUpdate& outUpdate)
+{
+    assert(firstMip < texture.MipCount);
+
+    const VkImageAspectFlags aspect = GetPlaneAspect(texture.Format, 1, 0);
+    auto getMipExtent = [&texture](uint32_t mip)
+    {
+        return VkExtent3D{std::max(texture.Extent.width >> mip, 1u), std::max(texture.Extent.height >> mip, 1u), std::max(texture.Extent.depth >> mip, 1u)};
+    };
+
+    outUpdate = ResidencyUpdate();
+    outUpdate.TextureId        = textureId;
+    outUpdate.OldImage         = texture.Image;
+    outUpdate.FirstResidentMip = firstMip;
+
+    // Read the missing top mips, they are stored contiguously in every array layer
+    const uint32_t readEndMip = std::min(texture.FirstResidentMip, texture.MipCount);
+    if (firstMip < readEndMip)
+    {
+        size_t readOffset = 0;
+        for (uint32_t i = 0; i < firstMip; i++)
+        {
+            readOffset += texture.MipByteSizes[i];
+        }
+
+        size_t readByteSize = 0;
+        for (uint32_t i = firstMip; i < readEndMip; i++)
+        {
+            readByteSize += texture.MipByteSizes[i];
+        }
+
+        LoadedTextureStorage& storage = outUpdate.Storage;
+        storage.DataByteSize = readByteSize * texture.ArraySize;
+        storage.PData.reset(new (std::nothrow) uint8_t[storage.DataByteSize]);
+        if (!storage.PData)
+        {
+            return DDS_LOADER_NO_HOST_MEMORY;
+        }
+
+        std::ifstream inFile(std::filesystem::path(texture.FileName), std::ios::in | std::ios::binary);
+        if (!inFile)
+            return DDS_LOADER_FAIL;
+
+        uint8_t* dstData = storage.PData.get();
+        for (uint32_t j = 0; j < texture.ArraySize; j++)
+        {
+            inFile.seekg(std::streamoff(texture.BitDataOffset + uint64_t(texture.LayerByteSize) * j + readOffset), std::ios::beg);
+            if (!ReadFileData(inFile, dstData, readByteSize))
+                return DDS_LOADER_UNEXPECTED_EOF;
+
+            for (uint32_t i = firstMip; i < readEndMip; i++)
+            {
+                LoadedSubresourceData subresource;
+                subresource.PData                       = dstData;
+                subresource.DataByteSize                = texture.MipByteSizes[i];
+                subresource.SubresourceSlice.aspectMask = aspect;
+                subresource.SubresourceSlice.mipLevel   = i - firstMip;
+                subresource.SubresourceSlice.arrayLayer = j;
+                subresource.Extent                      = getMipExtent(i);
+
+                outUpdate.Subresources.push_back(subresource);
+                dstData += subresource.DataByteSize;
+            }
+        }
+    }
+
+    // Copy the mips that stay resident
+    for (uint32_t i = std::max(firstMip, texture.FirstResidentMip); i < texture.MipCount; i++)
+    {
+        VkImageCopy region;
+        region.srcSubresource.aspectMask     = aspect;
+        region.srcSubresource.mipLevel       = i - texture.FirstResidentMip;
+        region.srcSubresource.baseArrayLayer = 0;
+        region.srcSubresource.layerCount     = texture.ArraySize;
+        region.srcOffset                     = {0, 0, 0};
+        region.dstSubresource                = region.srcSubresource;
+        region.dstSubresource.mipLevel       = i - firstMip;
+        region.dstOffset                     = {0, 0, 0};
+        region.extent                        = getMipExtent(i);
+
+        outUpdate.CopyRegions.push_back(region);
+    }
+
+    const VkExtent3D extent = getMipExtent(firstMip);
+    DDS_LOADER_RESULT errCode = CreateTextureResource(Device, texture.ImageType, extent.width, extent.height, extent.depth,
+        texture.MipCount - firstMip, texture.ArraySize, texture.Format, UsageFlags, texture.CreateFlags, LoadFlags,
+        texture.IsTypeless, AllocationCallbacks, &outUpdate.NewImage, &outUpdate.NewImageCreateInfo, &outUpdate.Storage);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        outUpdate = ResidencyUpdate();
+        return errCode;
+    }
+
+    if (texture.FirstResidentMip < texture.MipCount)
+    {
+        UsedByteSize -= GetResidentByteSize(texture, texture.FirstResidentMip);
+    }
+    UsedByteSize += GetResidentByteSize(texture, firstMip);
+
+    texture.Image            = outUpdate.NewImage;
+    texture.FirstResidentMip = firstMip;
+    return DDS_LOADER_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------
+// Texture pack archive
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::WriteTexturePack(
+    const char_type* packFileName,
+    const DDSTextureLoaderVk::TexturePackEntry* entries,
+    size_t entryCount,
+    VkDeviceSize copyOffsetAlignment,
+    bool compressPayloads)
+{
+    if (!packFileName || (!entries && entryCount) || entryCount > UINT32_MAX)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    // The table of contents is sorted by the name hash, the names have to be unique
+    std::vector<TEXTURE_PACK_TOC_ENTRY> toc(entryCount);
+    std::vector<size_t>                 tocOrder(entryCount);
+    for (size_t e = 0; e < entryCount; e++)
+    {
+        if (!entries[e].Name || !entries[e].FileName)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        toc[e].nameHash = HashTexturePackName(entries[e].Name);
+        tocOrder[e]     = e;
+    }
+
+    std::sort(tocOrder.begin(), tocOrder.end(), [&](size_t left, size_t right)
+    {
+        return toc[left].nameHash != toc[right].nameHash
+             ? toc[left].nameHash < toc[right].nameHash
+             : strcmp(entries[left].Name, entries[right].Name) < 0;
+    });
+
+    for (size_t e = 1; e < entryCount; e++)
+    {
+        if (strcmp(entries[tocOrder[e - 1]].Name, entries[tocOrder[e]].Name) == 0)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+    }
+
+    std::ofstream outFile(std::filesystem::path(packFileName), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outFile)
+        return DDS_LOADER_FAIL;
+
+    // Rewritten with the table offsets at the end
+    TEXTURE_PACK_HEADER packHeader = {};
+    outFile.write(reinterpret_cast<const char*>(&packHeader), sizeof(packHeader));
+
+    const uint64_t alignment = std::max<uint64_t>(copyOffsetAlignment, 1);
+
+    std::vector<TEXTURE_PACK_SUBRESOURCE> packSubresources;
+    std::vector<uint8_t>                  headerData;
+    std::string                           names;
+
+    std::unique_ptr<uint8_t[]>         ddsData;
+    std::vector<LoadedSubresourceData> dataSubresources;
+    std::vector<uint64_t>              dataOffsets;
+
+    std::vector<std::unique_ptr<uint8_t[]>> frames;
+    std::vector<size_t>                     frameSizes;
+
+    DDS_LOADER_RESULT errCode = DDS_LOADER_SUCCESS;
+    uint64_t fileOffset = sizeof(packHeader);
+    for (size_t e = 0; e < entryCount && errCode == DDS_LOADER_SUCCESS; e++)
+    {
+        const DDS_HEADER* header = nullptr;
+        const uint8_t* bitData = nullptr;
+        size_t bitSize = 0;
+
+        errCode = LoadTextureDataFromFile(entries[e].FileName, 0, WholeFileDataSize, ddsData, &header, &bitData, &bitSize);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            break;
+        }
+
+        TextureLayout layout;
+        errCode = GetTextureLayout(header, layout);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            break;
+        }
+
+        const uint32_t numberOfPlanes = GetVkFormatPlaneCount(layout.Format);
+        if (numberOfPlanes == 0)
+        {
+            errCode = DDS_LOADER_UNSUPPORTED_FORMAT;
+            break;
+        }
+
+        size_t skipMip = 0;
+        errCode = GetDataSubresources(layout, numberOfPlanes, 0, 0, bitSize, dataSubresources, dataOffsets, skipMip);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            break;
+        }
+
+        // Buffer to image copies need offsets that are multiples of the texel block size, and of 4 for depth/stencil formats
+        uint64_t payloadAlignment = std::lcm<uint64_t>(alignment, 4);
+        for (uint32_t p = 0; p < numberOfPlanes && errCode == DDS_LOADER_SUCCESS; ++p)
+        {
+            uint32_t blockWidth    = 0;
+            uint32_t blockHeight   = 0;
+            size_t   bytesPerBlock = 0;
+            errCode = GetBlockExtent(layout.Format, GetPlaneAspect(layout.Format, numberOfPlanes, p), &blockWidth, &blockHeight, &bytesPerBlock);
+            payloadAlignment = std::lcm<uint64_t>(payloadAlignment, std::max<size_t>(bytesPerBlock, 1));
+        }
+
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            break;
+        }
+
+        // Every subresource is a separate block so that the reader can decompress any of them, in parallel.
+        // A frame size of 0 stores the subresource as is, when it doesn't get smaller or the memory ran out
+        frames.clear();
+        frameSizes.assign(dataSubresources.size(), 0);
+        if (compressPayloads)
+        {
+            frames.resize(dataSubresources.size());
+            ParallelFor(dataSubresources.size(), 1, [&](size_t begin, size_t end)
+            {
+                std::unique_ptr<size_t[]> hashTable(new (std::nothrow) size_t[size_t(1) << Lz4HashLog]);
+                for (size_t k = begin; k < end && hashTable; k++)
+                {
+                    const size_t dataByteSize = dataSubresources[k].DataByteSize;
+                    frames[k].reset(new (std::nothrow) uint8_t[dataByteSize]);
+                    if (frames[k] && dataByteSize > 1)
+                    {
+                        // Blocks that would not be smaller than the data don't fit
+                        frameSizes[k] = CompressLz4Block(bitData + dataOffsets[k], dataByteSize, frames[k].get(), dataByteSize - 1, hashTable.get());
+                    }
+                }
+            });
+        }
+
+        if (!compressPayloads)
+        {
+            PadFileData(outFile, fileOffset, payloadAlignment);
+        }
+
+        TEXTURE_PACK_TOC_ENTRY& tocEntry = toc[e];
+        tocEntry.nameOffset       = names.size();
+        tocEntry.headerOffset     = headerData.size();
+        tocEntry.headerSize       = uint64_t(bitData - ddsData.get());
+        tocEntry.storedOffset     = fileOffset;
+        tocEntry.bitSize          = bitSize;
+        tocEntry.firstSubresource = static_cast<uint32_t>(packSubresources.size());
+        tocEntry.subresourceCount = static_cast<uint32_t>(dataSubresources.size());
+        tocEntry.flags            = compressPayloads ? TEXTURE_PACK_TEXTURE_COMPRESSED : 0;
+
+        // Uncompressed textures are stored in the payload layout, compressed frames are packed tightly
+        uint64_t payloadOffset = 0;
+        for (size_t k = 0; k < dataSubresources.size(); k++)
+        {
+            payloadOffset += (payloadAlignment - payloadOffset % payloadAlignment) % payloadAlignment;
+            if (!compressPayloads)
+            {
+                PadFileData(outFile, fileOffset, payloadAlignment);
+            }
+
+            TEXTURE_PACK_SUBRESOURCE packSubresource;
+            packSubresource.sourceOffset   = dataOffsets[k];
+            packSubresource.payloadOffset  = payloadOffset;
+            packSubresource.dataByteSize   = dataSubresources[k].DataByteSize;
+            packSubresource.storedOffset   = fileOffset - tocEntry.storedOffset;
+            packSubresource.storedByteSize = frameSizes[k] ? frameSizes[k] : dataSubresources[k].DataByteSize;
+            packSubresources.push_back(packSubresource);
+
+            const uint8_t* storedData = frameSizes[k] ? frames[k].get() : bitData + dataOffsets[k];
+            outFile.write(reinterpret_cast<const char*>(storedData), std::streamsize(packSubresource.storedByteSize));
+            fileOffset    += packSubresource.storedByteSize;
+            payloadOffset += packSubresource.dataByteSize;
+        }
+
+        tocEntry.storedSize  = fileOffset - tocEntry.storedOffset;
+        tocEntry.payloadSize = payloadOffset;
+
+        headerData.insert(headerData.end(), static_cast<const uint8_t*>(ddsData.get()), bitData);
+        names.append(entries[e].Name);
+        names.push_back('\0');
+
+        if (!outFile)
+        {
+            errCode = DDS_LOADER_FAIL;
+        }
+    }
+
+    if (errCode == DDS_LOADER_SUCCESS && packSubresources.size() > UINT32_MAX)
+    {
+        errCode = DDS_LOADER_ARITHMETIC_OVERFLOW;
+    }
+
+    if (errCode == DDS_LOADER_SUCCESS)
+    {
+        PadFileData(outFile, fileOffset, sizeof(uint64_t));
+        const uint64_t headerDataOffset = fileOffset;
+        outFile.write(reinterpret_cast<const char*>(headerData.data()), std::streamsize(headerData.size()));
+        fileOffset += headerData.size();
+
+        PadFileData(outFile, fileOffset, sizeof(uint64_t));
+        packHeader.tocOffset = fileOffset;
+        for (size_t e : tocOrder)
+        {
+            toc[e].headerOffset += headerDataOffset;
+            outFile.write(reinterpret_cast<const char*>(&toc[e]), sizeof(TEXTURE_PACK_TOC_ENTRY));
+        }
+        fileOffset += toc.size() * sizeof(TEXTURE_PACK_TOC_ENTRY);
+
+        packHeader.subresourceOffset = fileOffset;
+        outFile.write(reinterpret_cast<const char*>(packSubresources.data()), std::streamsize(packSubresources.size() * sizeof(TEXTURE_PACK_SUBRESOURCE)));
+        fileOffset += packSubresources.size() * sizeof(TEXTURE_PACK_SUBRESOURCE);
+
+        packHeader.namesOffset = fileOffset;
+        packHeader.namesSize   = names.size();
+        outFile.write(names.data(), std::streamsize(names.size()));
+
+        packHeader.magic               = TEXTURE_PACK_MAGIC;
+        packHeader.version             = TEXTURE_PACK_VERSION;
+        packHeader.textureCount        = static_cast<uint32_t>(toc.size());
+        packHeader.subresourceCount    = static_cast<uint32_t>(packSubresources.size());
+        packHeader.copyOffsetAlignment = alignment;
+
+        outFile.seekp(0, std::ios::beg);
+        outFile.write(reinterpret_cast<const char*>(&packHeader), sizeof(packHeader));
+        outFile.close();
+
+        if (!outFile)
+        {
+            errCode = DDS_LOADER_FAIL;
+        }
+    }
+
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        // Don't leave a partially written archive behind
+        outFile.close();
+        std::error_code removeError;
+        std::filesystem::remove(std::filesystem::path(packFileName), removeError);
+    }
+
+    return errCode;
+}
+
+DDSTextureLoaderVk::TexturePackReader::~TexturePackReader()
+{
+    Close();
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TexturePackReader::Open(const char_type* packFileName)
+{
+    Close();
+
+    if (!packFileName)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    DDS_LOADER_RESULT errCode = MapFile(packFileName, &MappedData, &MappedByteSize, &MappingHandle);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // Validate the tables once, the lookups only check the per-texture ranges
+    const uint64_t fileSize = MappedByteSize;
+    auto isInFile = [fileSize](uint64_t offset, uint64_t size)
+    {
+        return offset <= fileSize && size <= fileSize - offset;
+    };
+
+    const TEXTURE_PACK_HEADER* packHeader = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    if (MappedByteSize < sizeof(TEXTURE_PACK_HEADER) ||
+        packHeader->magic != TEXTURE_PACK_MAGIC ||
+        packHeader->version != TEXTURE_PACK_VERSION ||
+        (packHeader->tocOffset % sizeof(uint64_t)) != 0 ||
+        (packHeader->subresourceOffset % sizeof(uint64_t)) != 0 ||
+        !isInFile(packHeader->tocOffset, uint64_t(packHeader->textureCount) * sizeof(TEXTURE_PACK_TOC_ENTRY)) ||
+        !isInFile(packHeader->subresourceOffset, uint64_t(packHeader->subresourceCount) * sizeof(TEXTURE_PACK_SUBRESOURCE)) ||
+        !isInFile(packHeader->namesOffset, packHeader->namesSize) ||
+        (packHeader->namesSize != 0 && MappedData[packHeader->namesOffset + packHeader->namesSize - 1] != '\0'))
+    {
+        Close();
+        return DDS_LOADER_INVALID_DATA;
+    }
+
+    const TEXTURE_PACK_TOC_ENTRY*   toc              = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset);
+    const TEXTURE_PACK_SUBRESOURCE* packSubresources = reinterpret_cast<const TEXTURE_PACK_SUBRESOURCE*>(MappedData + packHeader->subresourceOffset);
+    for (uint32_t t = 0; t < packHeader->textureCount; t++)
+    {
+        const TEXTURE_PACK_TOC_ENTRY& tocEntry     = toc[t];
+        const bool                    isCompressed = (tocEntry.flags & TEXTURE_PACK_TEXTURE_COMPRESSED) != 0;
+        if (tocEntry.nameOffset >= packHeader->namesSize ||
+            (t != 0 && toc[t - 1].nameHash > tocEntry.nameHash) ||
+            (tocEntry.headerOffset % sizeof(uint32_t)) != 0 ||
+            !isInFile(tocEntry.headerOffset, tocEntry.headerSize) ||
+            !isInFile(tocEntry.storedOffset, tocEntry.storedSize) ||
+            tocEntry.payloadSize > SIZE_MAX ||
+            (!isCompressed && tocEntry.storedSize != tocEntry.payloadSize) ||
+            uint64_t(tocEntry.firstSubresource) + tocEntry.subresourceCount > packHeader->subresourceCount)
+        {
+            Close();
+            return DDS_LOADER_INVALID_DATA;
+        }
+
+        // The subresources are in the data order and don't overlap, uncompressed ones are stored in the payload layout
+        uint64_t payloadEnd = 0;
+        uint64_t sourceEnd  = 0;
+        for (uint32_t k = tocEntry.firstSubresource; k < tocEntry.firstSubresource + tocEntry.subresourceCount; k++)
+        {
+            const TEXTURE_PACK_SUBRESOURCE& packSubresource = packSubresources[k];
+            if (packSubresource.payloadOffset < payloadEnd ||
+                packSubresource.payloadOffset > tocEntry.payloadSize ||
+                packSubresource.dataByteSize > tocEntry.payloadSize - packSubresource.payloadOffset ||
+                packSubresource.sourceOffset < sourceEnd ||
+                packSubresource.sourceOffset > tocEntry.bitSize ||
+                packSubresource.dataByteSize > tocEntry.bitSize - packSubresource.sourceOffset ||
+                packSubresource.storedOffset > tocEntry.storedSize ||
+                packSubresource.storedByteSize > tocEntry.storedSize - packSubresource.storedOffset ||
+                packSubresource.storedByteSize > packSubresource.dataByteSize ||
+                (!isCompressed && (packSubresource.storedOffset != packSubresource.payloadOffset || packSubresource.storedByteSize != packSubresource.dataByteSize)))
+            {
+                Close();
+                return DDS_LOADER_INVALID_DATA;
+            }
+
+            payloadEnd = packSubresource.payloadOffset + packSubresource.dataByteSize;
+            sourceEnd  = packSubresource.sourceOffset + packSubresource.dataByteSize;
+        }
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+void DDSTextureLoaderVk::TexturePackReader::Close()
+{
+    UnmapFile(MappedData, MappedByteSize, MappingHandle);
+
+    MappedData     = nullptr;
+    MappedByteSize = 0;
+    MappingHandle  = nullptr;
+}
+
+uint32_t DDSTextureLoaderVk::TexturePackReader::GetTextureCount() const
+{
+    return MappedData ? reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData)->textureCount : 0;
+}
+
+const char* DDSTextureLoaderVk::TexturePackReader::GetTextureName(uint32_t textureIndex) const
+{
+    if (textureIndex >= GetTextureCount())
+    {
+        return nullptr;
+    }
+
+    const TEXTURE_PACK_HEADER*    packHeader = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    const TEXTURE_PACK_TOC_ENTRY* toc        = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset);
+    return reinterpret_cast<const char*>(MappedData + packHeader->namesOffset + toc[textureIndex].nameOffset);
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TexturePackReader::FindTexture(const char* name, uint32_t* outTextureIndex) const
+{
+    if (!name || !outTextureIndex)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const uint32_t textureCount = GetTextureCount();
+    if (textureCount == 0)
+    {
+        return DDS_LOADER_FAIL;
+    }
+
+    const TEXTURE_PACK_HEADER*    packHeader = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    const TEXTURE_PACK_TOC_ENTRY* toc        = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset);
+
+    const uint64_t nameHash = HashTexturePackName(name);
+    const TEXTURE_PACK_TOC_ENTRY* tocEntry = std::lower_bound(toc, toc + textureCount, nameHash, [](const TEXTURE_PACK_TOC_ENTRY& entry, uint64_t hash)
+    {
+        return entry.nameHash < hash;
+    });
+
+    for (; tocEntry != toc + textureCount && tocEntry->nameHash == nameHash; ++tocEntry)
+    {
+        const uint32_t textureIndex = static_cast<uint32_t>(tocEntry - toc);
+        if (strcmp(GetTextureName(textureIndex), name) == 0)
+        {
+            *outTextureIndex = textureIndex;
+            return DDS_LOADER_SUCCESS;
+        }
+    }
+
+    return DDS_LOADER_FAIL;
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TexturePackReader::GetTexturePayload(uint32_t textureIndex, const uint8_t** outData, size_t* outByteSize) const
+{
+    if (textureIndex >= GetTextureCount() || !outData || !outByteSize)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const TEXTURE_PACK_HEADER*    packHeader = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    const TEXTURE_PACK_TOC_ENTRY& tocEntry   = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset)[textureIndex];
+
+    *outData     = (tocEntry.flags & TEXTURE_PACK_TEXTURE_COMPRESSED) ? nullptr : MappedData + tocEntry.storedOffset;
+    *outByteSize = size_t(tocEntry.payloadSize);
+    return DDS_LOADER_SUCCESS;
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TexturePackReader::ReadTexturePayload(uint32_t textureIndex,
+    const VkBufferImageCopy* copyRegions,
+    size_t copyRegionCount,
+    void* dstPayload) const
+{
+    if (textureIndex >= GetTextureCount() || (!copyRegions && copyRegionCount) || !dstPayload)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const TEXTURE_PACK_HEADER*      packHeader       = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    const TEXTURE_PACK_TOC_ENTRY&   tocEntry         = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset)[textureIndex];
+    const TEXTURE_PACK_SUBRESOURCE* packSubresources = reinterpret_cast<const TEXTURE_PACK_SUBRESOURCE*>(MappedData + packHeader->subresourceOffset) + tocEntry.firstSubresource;
+
+    // The regions select the subresources by their payload offsets
+    std::vector<const TEXTURE_PACK_SUBRESOURCE*> selected(copyRegionCount);
+    for (size_t r = 0; r < copyRegionCount; r++)
+    {
+        const TEXTURE_PACK_SUBRESOURCE* packSubresource = std::lower_bound(packSubresources, packSubresources + tocEntry.subresourceCount, copyRegions[r].bufferOffset,
+            [](const TEXTURE_PACK_SUBRESOURCE& subresource, VkDeviceSize offset)
+        {
+            return subresource.payloadOffset < offset;
+        });
+
+        if (packSubresource == packSubresources + tocEntry.subresourceCount || packSubresource->payloadOffset != copyRegions[r].bufferOffset)
+        {
+            return DDS_LOADER_INVALID_ARG;
+        }
+
+        selected[r] = packSubresource;
+    }
+
+    const uint8_t*    storedData = MappedData + tocEntry.storedOffset;
+    uint8_t*          dstData    = static_cast<uint8_t*>(dstPayload);
+    std::atomic<bool> isValid(true);
+    ParallelFor(selected.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t r = begin; r < end; r++)
+        {
+            if (!ReadTexturePackSubresource(storedData, *selected[r], dstData + selected[r]->payloadOffset))
+            {
+                isValid = false;
+            }
+        }
+    });
+
+    return isValid ? DDS_LOADER_SUCCESS : DDS_LOADER_INVALID_DATA;
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TexturePackReader::LoadTexture(uint32_t textureIndex,
+    VkDevice vkDevice,
+    size_t maxsize,
+    const VkPhysicalDeviceLimits* deviceLimits,
+    VkImageUsageFlags usageFlags,
+    VkImageCreateFlags createFlags,
+    unsigned int loadFlags,
+    VkAllocationCallbacks* allocator,
+    VkImage* texture,
+    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+    std::vector<VkBufferImageCopy>* outCopyRegions,
+    VkImageCreateInfo* outImageCreateInfo,
+    DDS_ALPHA_MODE* outAlphaMode,
+    DDSTextureLoaderVk::LoadedTextureStorage* outStorage) const
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (outAlphaMode)
+    {
+        *outAlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+    }
+    if (outImageCreateInfo)
+    {
+        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+    }
+
+    subresources.clear();
+    if (outCopyRegions)
+    {
+        outCopyRegions->clear();
+    }
+
+    if (!IsValidTextureOutput(vkDevice, texture, outImageCreateInfo, loadFlags, nullptr) || textureIndex >= GetTextureCount())
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const TEXTURE_PACK_HEADER*     packHeader       = reinterpret_cast<const TEXTURE_PACK_HEADER*>(MappedData);
+    const TEXTURE_PACK_TOC_ENTRY&  tocEntry         = reinterpret_cast<const TEXTURE_PACK_TOC_ENTRY*>(MappedData + packHeader->tocOffset)[textureIndex];
+    const TEXTURE_PACK_SUBRESOURCE* packSubresources = reinterpret_cast<const TEXTURE_PACK_SUBRESOURCE*>(MappedData + packHeader->subresourceOffset) + tocEntry.firstSubresource;
+
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* bitData = nullptr;
+    size_t headerBitSize = 0;
+    DDS_LOADER_RESULT errCode = LoadTextureDataFromMemory(MappedData + tocEntry.headerOffset, size_t(tocEntry.headerSize), &header, &bitData, &headerBitSize);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // Match the pack subresources before the image gets created, both lists are in the data order
+    TextureLayout layout;
+    errCode = GetTextureLayout(header, layout);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    std::vector<LoadedSubresourceData> dataSubresources;
+    std::vector<uint64_t>              dataOffsets;
+    size_t                             skipMip = 0;
 
-            errCode = CreateTextureResource(vkDevice, imgType, twidth, theight, tdepth, reservedMips - skipMip, arraySize,
-                format, usageFlags, imageCreateFlags, loadFlags, allocationCallbacks, texture, outImageCreateInfo);
+    errCode = GetDataSubresources(layout, GetVkFormatPlaneCount(layout.Format), maxsize, 0, tocEntry.bitSize, dataSubresources, dataOffsets, skipMip);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
 
-            if (errCode != DDS_LOADER_SUCCESS && !maxsize && (mipCount > 1))
-            {
-                subresources.clear();
+    const uint8_t* storedData = MappedData + tocEntry.storedOffset;
 
-                maxsize = static_cast<size_t>(
-                    (imgType == VK_IMAGE_TYPE_3D)
-                    ? maxImageDimension3D
-                    : maxImageDimension2D);
+    std::vector<const TEXTURE_PACK_SUBRESOURCE*> selected(dataSubresources.size());
+    std::vector<const uint8_t*>                  dataPointers(dataSubresources.size());
+    size_t                                       compressedByteSize = 0;
+    uint32_t m = 0;
+    for (size_t k = 0; k < dataSubresources.size(); k++)
+    {
+        while (m < tocEntry.subresourceCount && packSubresources[m].sourceOffset < dataOffsets[k])
+        {
+            m++;
+        }
 
-                errCode = FillInitData(width, height, depth, mipCount, arraySize,
-                    numberOfPlanes, format,
-                    maxsize, bitSize, bitData,
-                    twidth, theight, tdepth, skipMip, subresources);
-                if (errCode == DDS_LOADER_SUCCESS)
-                {
-                    errCode = CreateTextureResource(vkDevice, imgType, twidth, theight, tdepth, mipCount - skipMip, arraySize,
-                        format, usageFlags, imageCreateFlags, loadFlags, allocationCallbacks, texture, outImageCreateInfo);
-                }
-            }
+        if (m == tocEntry.subresourceCount ||
+            packSubresources[m].sourceOffset != dataOffsets[k] ||
+            packSubresources[m].dataByteSize != dataSubresources[k].DataByteSize)
+        {
+            return DDS_LOADER_INVALID_DATA;
         }
 
-        if (errCode != DDS_LOADER_SUCCESS)
+        selected[k] = packSubresources + m;
+        if (selected[k]->storedByteSize == selected[k]->dataByteSize)
         {
-            subresources.clear();
+            dataPointers[k] = storedData + selected[k]->storedOffset;
+        }
+        else
+        {
+            compressedByteSize += size_t(selected[k]->dataByteSize);
         }
+    }
 
-        return errCode;
+    // Without the storage the compressed subresources can only be read through the copy regions with ReadTexturePayload()
+    if (compressedByteSize != 0 && !outStorage && !outCopyRegions)
+    {
+        return DDS_LOADER_INVALID_ARG;
     }
 
-    //--------------------------------------------------------------------------------------
-    DDS_ALPHA_MODE GetAlphaMode( _In_ const DDS_HEADER* header ) noexcept
+    // Decompress only the selected compressed subresources, into the storage
+    if (compressedByteSize != 0 && outStorage)
     {
-        if ( header->ddspf.flags & DDS_FOURCC )
+        outStorage->PData.reset(new (std::nothrow) uint8_t[compressedByteSize]);
+        outStorage->DataByteSize = compressedByteSize;
+        if (!outStorage->PData)
         {
-            if ( MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC )
-            {
-                auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>(reinterpret_cast<const uint8_t*>(header) + sizeof(DDS_HEADER));
-                auto mode = static_cast<DDS_ALPHA_MODE>( d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK );
-                switch( mode )
-                {
-                case DDS_ALPHA_MODE_STRAIGHT:
-                case DDS_ALPHA_MODE_PREMULTIPLIED:
-                case DDS_ALPHA_MODE_OPAQUE:
-                case DDS_ALPHA_MODE_CUSTOM:
-                    return mode;
+            outStorage->DataByteSize = 0;
+            return DDS_LOADER_NO_HOST_MEMORY;
+        }
 
-                case DDS_ALPHA_MODE_UNKNOWN:
-                default:
-                    break;
-                }
+        std::vector<size_t> compressed;
+        size_t storageOffset = 0;
+        for (size_t k = 0; k < selected.size(); k++)
+        {
+            if (!dataPointers[k])
+            {
+                dataPointers[k] = outStorage->PData.get() + storageOffset;
+                storageOffset  += size_t(selected[k]->dataByteSize);
+                compressed.push_back(k);
             }
-            else if ( ( MAKEFOURCC( 'D', 'X', 'T', '2' ) == header->ddspf.fourCC )
-                      || ( MAKEFOURCC( 'D', 'X', 'T', '4' ) == header->ddspf.fourCC ) )
+        }
+
+        std::atomic<bool> isValid(true);
+        ParallelFor(compressed.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t c = begin; c < end; c++)
             {
-                return DDS_ALPHA_MODE_PREMULTIPLIED;
+                const size_t k = compressed[c];
+                if (!ReadTexturePackSubresource(storedData, *selected[k], const_cast<uint8_t*>(dataPointers[k])))
+                {
+                    isValid = false;
+                }
             }
+        });
+
+        if (!isValid)
+        {
+            return DDS_LOADER_INVALID_DATA;
         }
+    }
 
-        return DDS_ALPHA_MODE_UNKNOWN;
+    errCode = CreateTextureFromHeader(vkDevice, header, 0, tocEntry.bitSize, maxsize, deviceLimits,
+        usageFlags, createFlags, loadFlags, allocator, texture, outImageCreateInfo, outStorage, dataSubresources, dataOffsets, skipMip);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
     }
 
-    //--------------------------------------------------------------------------------------
-    void SetDebugTextureInfo(
-        VkDevice device,
-        const char* fileName,
-        VkImage image) noexcept
+    subresources.reserve(dataSubresources.size());
+    for (size_t k = 0; k < dataSubresources.size(); k++)
     {
-#if defined(VK_EXT_debug_utils) && !defined(NO_VK_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
-        if(image != VK_NULL_HANDLE)
+        LoadedSubresourceData subresource = dataSubresources[k];
+        subresource.PData                      = dataPointers[k];
+        subresource.SubresourceSlice.mipLevel -= static_cast<uint32_t>(skipMip);
+        subresources.push_back(subresource);
+
+        if (outCopyRegions)
         {
-            const char* pstrName = strrchr(fileName, '\\');
-            if (!pstrName)
-            {
-                pstrName = fileName;
-            }
-            else
-            {
-                pstrName++;
-            }
+            VkBufferImageCopy region;
+            region.bufferOffset                    = selected[k]->payloadOffset;
+            region.bufferRowLength                 = 0;
+            region.bufferImageHeight               = 0;
+            region.imageSubresource.aspectMask     = subresource.SubresourceSlice.aspectMask;
+            region.imageSubresource.mipLevel       = subresource.SubresourceSlice.mipLevel;
+            region.imageSubresource.baseArrayLayer = subresource.SubresourceSlice.arrayLayer;
+            region.imageSubresource.layerCount     = 1;
+            region.imageOffset                     = {0, 0, 0};
+            region.imageExtent                     = subresource.Extent;
+
+            outCopyRegions->push_back(region);
+        }
+    }
 
-            VkDebugUtilsObjectNameInfoEXT debugObjectNameInfo;
-            debugObjectNameInfo.sType        = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
-            debugObjectNameInfo.pNext        = nullptr;
-            debugObjectNameInfo.objectType   = VK_OBJECT_TYPE_IMAGE;
-            debugObjectNameInfo.objectHandle = (uint64_t)image;
-            debugObjectNameInfo.pObjectName  = fileName;
+    if (outAlphaMode)
+    {
+        *outAlphaMode = GetAlphaMode(header);
+    }
 
-            if(vkSetDebugUtilsObjectNameEXT != nullptr)
-            {
-                vkSetDebugUtilsObjectNameEXT(device, &debugObjectNameInfo);
-            }
-        }
-#else
-        UNREFERENCED_PARAMETER(device);
-        UNREFERENCED_PARAMETER(fileName);
-        UNREFERENCED_PARAMETER(image);
-#endif
+    if (texture)
+    {
+        SetDebugTextureInfo(vkDevice, GetTextureName(textureIndex), *texture);
     }
-} // anonymous namespace
 
-#ifdef VK_NO_PROTOTYPES
+    return DDS_LOADER_SUCCESS;
+}
 
-    void DDSTextureLoaderVk::SetVkCreateImageFuncPtr(PFN_vkCreateImage funcPtr)
+//--------------------------------------------------------------------------------------
+// Texture index
+//--------------------------------------------------------------------------------------
+DDS_LOADER_RESULT DDSTextureLoaderVk::UpdateTextureIndex(
+    const char_type* directory,
+    const char_type* indexFileName,
+    size_t* outParsedCount)
+{
+    if (outParsedCount)
     {
-        vkCreateImage = funcPtr;
+        *outParsedCount = 0;
     }
 
-    void DDSTextureLoaderVk::SetVkCreateImageFuncPtrWithUserPtr(DDSTextureLoaderVk::PFN_DdsLoader_vkCreateImageUserPtr funcPtr)
+    if (!directory || !indexFileName)
     {
-        vkCreateImageWithUserPtr = funcPtr;
+        return DDS_LOADER_INVALID_ARG;
+    }
 
-        vkCreateImage = [](VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage)
+    // A missing or invalid index is rebuilt from scratch
+    TextureIndexReader previousIndex;
+    const bool hasPreviousIndex = previousIndex.Open(indexFileName) == DDS_LOADER_SUCCESS;
+
+    std::error_code errorCode;
+    std::filesystem::directory_iterator directoryIterator(std::filesystem::path(directory), errorCode);
+    if (errorCode)
+    {
+        return DDS_LOADER_FAIL;
+    }
+
+    std::vector<TEXTURE_INDEX_ENTRY> entries;
+    std::vector<IndexedSubresource>  subresources;
+    std::vector<std::string>         fileNames;
+    std::vector<IndexedSubresource>  fileSubresources;
+    size_t                           parsedCount = 0;
+    bool                             isChanged   = false;
+
+    for (const std::filesystem::directory_entry& directoryEntry : directoryIterator)
+    {
+        std::string extension = directoryEntry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+        if (extension != ".dds" || !directoryEntry.is_regular_file(errorCode))
         {
-            return vkCreateImageWithUserPtr(vkCreateImageUserPtr, device, pCreateInfo, pAllocator, pImage);
-        };
+            continue;
+        }
+
+        const uint64_t fileSize      = directoryEntry.file_size(errorCode);
+        const int64_t  lastWriteTime = errorCode ? 0 : int64_t(directoryEntry.last_write_time(errorCode).time_since_epoch().count());
+        if (errorCode)
+        {
+            continue;
+        }
+
+        TEXTURE_INDEX_ENTRY entry = {};
+        entry.fileSize      = fileSize;
+        entry.lastWriteTime = lastWriteTime;
+
+        // Reuse the entries of the unchanged files, parse the headers of the new and modified ones.
+        // The files that fail to parse are left out of the index
+        const std::string fileName = GetUtf8FileName(directoryEntry.path());
+
+        uint32_t       previousTextureIndex = 0;
+        IndexedTexture previousTexture      = {};
+        if (previousIndex.FindTexture(fileName.c_str(), &previousTextureIndex) == DDS_LOADER_SUCCESS &&
+            previousIndex.GetTexture(previousTextureIndex, &previousTexture) == DDS_LOADER_SUCCESS &&
+            previousTexture.FileSize == fileSize &&
+            previousTexture.LastWriteTime == lastWriteTime)
+        {
+            entry.imageType   = static_cast<uint32_t>(previousTexture.ImageType);
+            entry.format      = static_cast<uint32_t>(previousTexture.Format);
+            entry.width       = previousTexture.Extent.width;
+            entry.height      = previousTexture.Extent.height;
+            entry.depth       = previousTexture.Extent.depth;
+            entry.mipLevels   = previousTexture.MipLevels;
+            entry.arrayLayers = previousTexture.ArrayLayers;
+            entry.createFlags = static_cast<uint32_t>(previousTexture.CreateFlags);
+            entry.alphaMode   = static_cast<uint32_t>(previousTexture.AlphaMode);
+            fileSubresources.assign(previousTexture.Subresources, previousTexture.Subresources + previousTexture.SubresourceCount);
+        }
+        else
+        {
+            parsedCount++;
+            // path::c_str() returns wchar_t on Windows whatever char_type is
+            if (IndexTextureFile(directoryEntry.path().string<char_type>().c_str(), entry, fileSubresources) != DDS_LOADER_SUCCESS)
+            {
+                continue;
+            }
+
+            isChanged = true;
+        }
+
+        entry.nameHash         = HashTexturePackName(fileName.c_str());
+        entry.firstSubresource = static_cast<uint32_t>(subresources.size());
+        entry.subresourceCount = static_cast<uint32_t>(fileSubresources.size());
+
+        entries.push_back(entry);
+        fileNames.push_back(fileName);
+        subresources.insert(subresources.end(), fileSubresources.begin(), fileSubresources.end());
     }
 
-    void DDSTextureLoaderVk::SetVkCreateImageUserPtr(void* userPtr)
+    if (outParsedCount)
     {
-        vkCreateImageUserPtr = userPtr;
+        *outParsedCount = parsedCount;
     }
 
-#ifdef VK_EXT_debug_utils
+    if (entries.size() > UINT32_MAX || subresources.size() > UINT32_MAX)
+    {
+        return DDS_LOADER_ARITHMETIC_OVERFLOW;
+    }
 
-    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameFuncPtr(PFN_vkSetDebugUtilsObjectNameEXT funcPtr)
+    // Keep the index (and its mappings in other processes) if nothing changed
+    if (hasPreviousIndex && !isChanged && previousIndex.GetTextureCount() == entries.size())
     {
-        vkSetDebugUtilsObjectNameEXT = funcPtr;
+        return DDS_LOADER_SUCCESS;
     }
 
-    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameFuncPtrWithUserPtr(DDSTextureLoaderVk::PFN_DdsLoader_vkSetDebugUtilsObjectNameUserPtr funcPtr)
+    previousIndex.Close();
+
+    std::vector<size_t> entryOrder(entries.size());
+    std::iota(entryOrder.begin(), entryOrder.end(), size_t(0));
+    std::sort(entryOrder.begin(), entryOrder.end(), [&](size_t left, size_t right)
     {
-        vkSetDebugUtilsObjectNameEXTWithUserPtr = funcPtr;
+        return entries[left].nameHash != entries[right].nameHash
+             ? entries[left].nameHash < entries[right].nameHash
+             : fileNames[left] < fileNames[right];
+    });
 
-        vkSetDebugUtilsObjectNameEXT = [](VkDevice device, const VkDebugUtilsObjectNameInfoEXT* pNameInfo)
-        {
-            return vkSetDebugUtilsObjectNameEXTWithUserPtr(vkSetDebugUtilsObjectNameEXTUserPtr, device, pNameInfo);
-        };
+    std::string names;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        entries[e].nameOffset = names.size();
+        names.append(fileNames[e]);
+        names.push_back('\0');
     }
 
-    void DDSTextureLoaderVk::SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr)
+    TEXTURE_INDEX_HEADER indexHeader = {};
+    indexHeader.magic             = TEXTURE_INDEX_MAGIC;
+    indexHeader.version           = TEXTURE_INDEX_VERSION;
+    indexHeader.textureCount      = static_cast<uint32_t>(entries.size());
+    indexHeader.subresourceCount  = static_cast<uint32_t>(subresources.size());
+    indexHeader.entriesOffset     = sizeof(TEXTURE_INDEX_HEADER);
+    indexHeader.subresourceOffset = indexHeader.entriesOffset + entries.size() * sizeof(TEXTURE_INDEX_ENTRY);
+    indexHeader.namesOffset       = indexHeader.subresourceOffset + subresources.size() * sizeof(IndexedSubresource);
+    indexHeader.namesSize         = names.size();
+
+    // Written next to the index and renamed over it, so that a failed update leaves the previous index intact
+    std::filesystem::path temporaryFileName(indexFileName);
+    temporaryFileName += ".tmp";
+
+    std::ofstream outFile(temporaryFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outFile)
+        return DDS_LOADER_FAIL;
+
+    outFile.write(reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader));
+    for (size_t e : entryOrder)
     {
-        vkSetDebugUtilsObjectNameEXTUserPtr = userPtr;
+        outFile.write(reinterpret_cast<const char*>(&entries[e]), sizeof(TEXTURE_INDEX_ENTRY));
     }
+    outFile.write(reinterpret_cast<const char*>(subresources.data()), std::streamsize(subresources.size() * sizeof(IndexedSubresource)));
+    outFile.write(names.data(), std::streamsize(names.size()));
+    outFile.close();
 
-#endif // VK_EXT_debug_utils
-#endif // VK_NO_PROTOTYPES
+    if (outFile)
+    {
+        std::filesystem::rename(temporaryFileName, std::filesystem::path(indexFileName), errorCode);
+    }
 
-std::string DDSLoaderResultToString(DDS_LOADER_RESULT errorCode)
+    if (!outFile || errorCode)
+    {
+        std::filesystem::remove(temporaryFileName, errorCode);
+        return DDS_LOADER_FAIL;
+    }
+
+    return DDS_LOADER_SUCCESS;
+}
+
+DDSTextureLoaderVk::TextureIndexReader::~TextureIndexReader()
 {
-    switch (errorCode)
+    Close();
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TextureIndexReader::Open(const char_type* indexFileName)
+{
+    Close();
+
+    if (!indexFileName)
     {
-    case DDSTextureLoaderVk::DDS_LOADER_SUCCESS:
-        return "Operation was successful.";
-    case DDSTextureLoaderVk::DDS_LOADER_FAIL:
-        return "Unexpected failure when reading the file.";
-    case DDSTextureLoaderVk::DDS_LOADER_BAD_POINTER:
-        return "Incorrect pointer has been passed to the function.";
-    case DDSTextureLoaderVk::DDS_LOADER_INVALID_ARG:
-        return "Incorrect argument has been passed to the function.";
-    case DDSTextureLoaderVk::DDS_LOADER_INVALID_DATA:
-        return "File contains invalid information.";
-    case DDSTextureLoaderVk::DDS_LOADER_UNEXPECTED_EOF:
-        return "Unexpected end of file.";
-    case DDSTextureLoaderVk::DDS_LOADER_UNSUPPORTED_FORMAT:
-        return "The image has unsupported format.";
-    case DDSTextureLoaderVk::DDS_LOADER_UNSUPPORTED_LAYOUT:
-        return "The image has incorrect or unsupported layout.";
-    case DDSTextureLoaderVk::DDS_LOADER_BELOW_LIMITS:
-        return "The image dimensions exceed the given device limits. Note that if you don't pass VkPhysicalDeviceLimits* parameter, the limits are set to minimum possible.";
-    case DDSTextureLoaderVk::DDS_LOADER_NO_HOST_MEMORY:
-        return "Out of system memory.";
-    case DDSTextureLoaderVk::DDS_LOADER_NO_DEVICE_MEMORY:
-        return "Out of video memory.";
-    case DDSTextureLoaderVk::DDS_LOADER_NO_FUNCTION:
-        return "The function vkCreateImage() has not been loaded. Please use SetVkCreateImageFuncPtr() or SetVkCreateImageFuncPtrWithUserPtr()+SetVkCreateImageUserPtr() to pass the function to the loader.";
-    case DDSTextureLoaderVk::DDS_LOADER_ARITHMETIC_OVERFLOW:
-        return "Unexpected arithmetic overflow when reading the file.";
-    default:
-        return "Unknown error code.";
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    DDS_LOADER_RESULT errCode = MapFile(indexFileName, &MappedData, &MappedByteSize, &MappingHandle);
+    if (errCode != DDS_LOADER_SUCCESS)
+    {
+        return errCode;
+    }
+
+    // Validate the tables once, the lookups don't check anything
+    const uint64_t fileSize = MappedByteSize;
+    auto isInFile = [fileSize](uint64_t offset, uint64_t size)
+    {
+        return offset <= fileSize && size <= fileSize - offset;
+    };
+
+    const TEXTURE_INDEX_HEADER* indexHeader = reinterpret_cast<const TEXTURE_INDEX_HEADER*>(MappedData);
+    if (MappedByteSize < sizeof(TEXTURE_INDEX_HEADER) ||
+        indexHeader->magic != TEXTURE_INDEX_MAGIC ||
+        indexHeader->version != TEXTURE_INDEX_VERSION ||
+        (indexHeader->entriesOffset % sizeof(uint64_t)) != 0 ||
+        (indexHeader->subresourceOffset % sizeof(uint64_t)) != 0 ||
+        !isInFile(indexHeader->entriesOffset, uint64_t(indexHeader->textureCount) * sizeof(TEXTURE_INDEX_ENTRY)) ||
+        !isInFile(indexHeader->subresourceOffset, uint64_t(indexHeader->subresourceCount) * sizeof(IndexedSubresource)) ||
+        !isInFile(indexHeader->namesOffset, indexHeader->namesSize) ||
+        (indexHeader->namesSize != 0 && MappedData[indexHeader->namesOffset + indexHeader->namesSize - 1] != '\0'))
+    {
+        Close();
+        return DDS_LOADER_INVALID_DATA;
+    }
+
+    const TEXTURE_INDEX_ENTRY* entries = reinterpret_cast<const TEXTURE_INDEX_ENTRY*>(MappedData + indexHeader->entriesOffset);
+    for (uint32_t t = 0; t < indexHeader->textureCount; t++)
+    {
+        if (entries[t].nameOffset >= indexHeader->namesSize ||
+            (t != 0 && entries[t - 1].nameHash > entries[t].nameHash) ||
+            uint64_t(entries[t].firstSubresource) + entries[t].subresourceCount > indexHeader->subresourceCount)
+        {
+            Close();
+            return DDS_LOADER_INVALID_DATA;
+        }
     }
+
+    return DDS_LOADER_SUCCESS;
 }
 
-//--------------------------------------------------------------------------------------
-DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromMemory(
-    VkDevice vkDevice,
-    const uint8_t* ddsData,
-    size_t ddsDataSize,
-    VkImage* texture,
-    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
-    size_t maxsize,
-    VkImageCreateInfo* outImageCreateInfo,
-    DDS_ALPHA_MODE* alphaMode)
+void DDSTextureLoaderVk::TextureIndexReader::Close()
 {
-    return LoadDDSTextureFromMemoryEx(
-        vkDevice,
-        ddsData,
-        ddsDataSize,
-        maxsize,
-        nullptr,
-        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        0,
-        DDS_LOADER_DEFAULT,
-        nullptr,
-        texture,
-        subresources,
-        outImageCreateInfo,
-        alphaMode);
+    UnmapFile(MappedData, MappedByteSize, MappingHandle);
+
+    MappedData     = nullptr;
+    MappedByteSize = 0;
+    MappingHandle  = nullptr;
+}
+
+uint32_t DDSTextureLoaderVk::TextureIndexReader::GetTextureCount() const
+{
+    return MappedData ? reinterpret_cast<const TEXTURE_INDEX_HEADER*>(MappedData)->textureCount : 0;
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TextureIndexReader::FindTexture(const char* fileName, uint32_t* outTextureIndex) const
+{
+    if (!fileName || !outTextureIndex)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const uint32_t textureCount = GetTextureCount();
+    if (textureCount == 0)
+    {
+        return DDS_LOADER_FAIL;
+    }
+
+    const TEXTURE_INDEX_HEADER* indexHeader = reinterpret_cast<const TEXTURE_INDEX_HEADER*>(MappedData);
+    const TEXTURE_INDEX_ENTRY*  entries     = reinterpret_cast<const TEXTURE_INDEX_ENTRY*>(MappedData + indexHeader->entriesOffset);
+
+    const uint64_t nameHash = HashTexturePackName(fileName);
+    const TEXTURE_INDEX_ENTRY* entry = std::lower_bound(entries, entries + textureCount, nameHash, [](const TEXTURE_INDEX_ENTRY& indexEntry, uint64_t hash)
+    {
+        return indexEntry.nameHash < hash;
+    });
+
+    for (; entry != entries + textureCount && entry->nameHash == nameHash; ++entry)
+    {
+        if (strcmp(reinterpret_cast<const char*>(MappedData + indexHeader->namesOffset + entry->nameOffset), fileName) == 0)
+        {
+            *outTextureIndex = static_cast<uint32_t>(entry - entries);
+            return DDS_LOADER_SUCCESS;
+        }
+    }
+
+    return DDS_LOADER_FAIL;
 }
 
+DDS_LOADER_RESULT DDSTextureLoaderVk::TextureIndexReader::GetTexture(uint32_t textureIndex, DDSTextureLoaderVk::IndexedTexture* outTexture) const
+{
+    if (textureIndex >= GetTextureCount() || !outTexture)
+    {
+        return DDS_LOADER_INVALID_ARG;
+    }
+
+    const TEXTURE_INDEX_HEADER* indexHeader = reinterpret_cast<const TEXTURE_INDEX_HEADER*>(MappedData);
+    const TEXTURE_INDEX_ENTRY&  entry       = reinterpret_cast<const TEXTURE_INDEX_ENTRY*>(MappedData + indexHeader->entriesOffset)[textureIndex];
+
+    outTexture->FileName         = reinterpret_cast<const char*>(MappedData + indexHeader->namesOffset + entry.nameOffset);
+    outTexture->FileSize         = entry.fileSize;
+    outTexture->LastWriteTime    = entry.lastWriteTime;
+    outTexture->ImageType        = static_cast<VkImageType>(entry.imageType);
+    outTexture->Format           = static_cast<VkFormat>(entry.format);
+    outTexture->Extent           = {entry.width, entry.height, entry.depth};
+    outTexture->MipLevels        = entry.mipLevels;
+    outTexture->ArrayLayers      = entry.arrayLayers;
+    outTexture->CreateFlags      = static_cast<VkImageCreateFlags>(entry.createFlags);
+    outTexture->AlphaMode        = static_cast<DDS_ALPHA_MODE>(entry.alphaMode);
+    outTexture->Subresources     = reinterpret_cast<const IndexedSubresource*>(MappedData + indexHeader->subresourceOffset) + entry.firstSubresource;
+    outTexture->SubresourceCount = entry.subresourceCount;
+    return DDS_LOADER_SUCCESS;
+}
 
-DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromMemoryEx(
-    VkDevice vkDevice,
-    const uint8_t* ddsData,
-    size_t ddsDataSize,
+//--------------------------------------------------------------------------------------
+// Texture file watcher
+//--------------------------------------------------------------------------------------
+DDSTextureLoaderVk::TextureFileWatcher::TextureFileWatcher(VkDevice vkDevice,
     size_t maxsize,
     const VkPhysicalDeviceLimits* deviceLimits,
     VkImageUsageFlags usageFlags,
     VkImageCreateFlags createFlags,
     unsigned int loadFlags,
-    VkAllocationCallbacks* allocator,
-    VkImage* texture,
-    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
-    VkImageCreateInfo* outImageCreateInfo,
-    DDS_ALPHA_MODE* alphaMode)
+    const VkAllocationCallbacks* allocationCallbacks,
+    uint32_t coalesceMilliseconds)
+    : Device(vkDevice)
+    , MaxSize(maxsize)
+    , DeviceLimits()
+    , HasDeviceLimits(deviceLimits != nullptr)
+    , UsageFlags(usageFlags)
+    , CreateFlags(createFlags)
+    , LoadFlags(loadFlags)
+    , AllocationCallbacks(allocationCallbacks)
+    , CoalesceMilliseconds(coalesceMilliseconds)
+    , NextTextureId(1)
+    , NotifyHandle(-1)
+    , IsStopping(false)
 {
-    if (texture)
+    if (deviceLimits)
     {
-        *texture = nullptr;
+        DeviceLimits = *deviceLimits;
     }
-    if (alphaMode)
+}
+
+DDSTextureLoaderVk::TextureFileWatcher::~TextureFileWatcher()
+{
+    Stop();
+
+#ifdef __linux__
+    if (NotifyHandle >= 0)
     {
-        *alphaMode = DDS_ALPHA_MODE_UNKNOWN;
+        close(NotifyHandle);
     }
-    if (outImageCreateInfo)
+#endif
+}
+
+void DDSTextureLoaderVk::TextureFileWatcher::Stop()
+{
+    // AddTexture starts the thread under the lock, so no new one can start after this
+    std::thread watchThread;
     {
-        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+        std::lock_guard<std::mutex> lock(TexturesMutex);
+        IsStopping = true;
+        watchThread = std::move(WatchThread);
+    }
+
+    // The reload in flight finishes and queues its update before the thread exits
+    if (watchThread.joinable())
+    {
+        watchThread.join();
+    }
+}
+
+DDS_LOADER_RESULT DDSTextureLoaderVk::TextureFileWatcher::AddTexture(const char_type* fileName,
+    WatchedTextureId* outTextureId,
+    WatchedTextureUpdate& outUpdate)
+{
+    if (outTextureId)
+    {
+        *outTextureId = 0;
     }
 
-    if(!vkDevice || !ddsData || !texture)
+    outUpdate = WatchedTextureUpdate();
+
+    if (!Device || !fileName || !outTextureId)
     {
         return DDS_LOADER_INVALID_ARG;
     }
 
-    // Validate DDS file in memory
-    const DDS_HEADER* header = nullptr;
-    const uint8_t* bitData = nullptr;
-    size_t bitSize = 0;
+    // The events carry the names relative to the watched directories, the paths are kept absolute to match them
+    std::error_code errorCode;
+    const std::filesystem::path filePath = std::filesystem::absolute(std::filesystem::path(fileName), errorCode).lexically_normal();
+    if (errorCode)
+    {
+        return DDS_LOADER_FAIL;
+    }
 
-    DDS_LOADER_RESULT errCode = LoadTextureDataFromMemory(ddsData,
-        ddsDataSize,
-        &header,
-        &bitData,
-        &bitSize
-    );
+    const std::basic_string<char_type> directory = filePath.parent_path().string<char_type>();
+
+    DDS_LOADER_RESULT errCode = DDS_LOADER_SUCCESS;
+    {
+        std::lock_guard<std::mutex> lock(TexturesMutex);
+        if (IsStopping)
+        {
+            return DDS_LOADER_FAIL;
+        }
+
+        errCode = WatchDirectory(directory);
+        if (errCode != DDS_LOADER_SUCCESS)
+        {
+            return errCode;
+        }
+
+        if (!WatchThread.joinable())
+        {
+            try
+            {
+                WatchThread = std::thread(&TextureFileWatcher::Run, this);
+            }
+            catch (const std::system_error&)
+            {
+                UnwatchDirectory(directory);
+                return DDS_LOADER_FAIL;
+            }
+        }
+    }
+
+    WatchedTexture texture;
+    texture.FilePath      = filePath.string<char_type>();
+    texture.LastWriteTime = int64_t(std::filesystem::last_write_time(filePath, errorCode).time_since_epoch().count());
+
+    errCode = ReloadDDSTextureFromFile(Device, texture.FilePath.c_str(), MaxSize, HasDeviceLimits ? &DeviceLimits : nullptr,
+        UsageFlags, CreateFlags, LoadFlags, const_cast<VkAllocationCallbacks*>(AllocationCallbacks), texture.State, outUpdate.DdsData, outUpdate.Subresources);
+
+    std::lock_guard<std::mutex> lock(TexturesMutex);
     if (errCode != DDS_LOADER_SUCCESS)
     {
+        UnwatchDirectory(directory);
         return errCode;
     }
 
-    errCode = CreateTextureFromDDS(vkDevice,
-        header, bitData, bitSize, maxsize,
-        deviceLimits, usageFlags, createFlags, loadFlags,
-        allocator, texture, subresources, outImageCreateInfo);
-    if (errCode == DDS_LOADER_SUCCESS)
+    const WatchedTextureId textureId = NextTextureId++;
+
+    outUpdate.TextureId       = textureId;
+    outUpdate.Image           = texture.State.Image;
+    outUpdate.ImageCreateInfo = texture.State.ImageCreateInfo;
+
+    TexturesByPath.emplace(texture.FilePath, textureId);
+    Textures.emplace(textureId, std::move(texture));
+
+    *outTextureId = textureId;
+    return DDS_LOADER_SUCCESS;
+}
+
+VkImage DDSTextureLoaderVk::TextureFileWatcher::RemoveTexture(WatchedTextureId textureId)
+{
+    std::lock_guard<std::mutex> lock(TexturesMutex);
+
+    auto texture = Textures.find(textureId);
+    if (texture == Textures.end())
     {
-        if (texture && *texture)
+        return VK_NULL_HANDLE;
+    }
+
+    const VkImage image = texture->second.State.Image;
+
+    auto paths = TexturesByPath.equal_range(texture->second.FilePath);
+    for (auto path = paths.first; path != paths.second; ++path)
+    {
+        if (path->second == textureId)
         {
-            SetDebugObjectName(vkDevice, *texture, "DDSTextureLoader");
+            TexturesByPath.erase(path);
+            break;
         }
-
-        if (alphaMode)
-            *alphaMode = GetAlphaMode(header);
     }
 
-    return errCode;
+    UnwatchDirectory(std::filesystem::path(texture->second.FilePath).parent_path().string<char_type>());
+    Textures.erase(texture);
+    return image;
 }
 
-
-//--------------------------------------------------------------------------------------
-DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFile(
-    VkDevice vkDevice,
-    const char_type* fileName,
-    VkImage* texture,
-    std::unique_ptr<uint8_t[]>& ddsData,
-    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
-    size_t maxsize,
-    VkImageCreateInfo* outImageCreateInfo,
-    DDS_ALPHA_MODE* outAlphaMode)
+bool DDSTextureLoaderVk::TextureFileWatcher::PopUpdate(WatchedTextureUpdate& outUpdate)
 {
-    return LoadDDSTextureFromFileEx(
-        vkDevice,
-        fileName,
-        maxsize,
-        nullptr,
-        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-        0,
-        DDS_LOADER_DEFAULT,
-        nullptr,
-        texture,
-        ddsData,
-        subresources,
-        outImageCreateInfo,
-        outAlphaMode);
+    std::lock_guard<std::mutex> lock(UpdatesMutex);
+    if (Updates.empty())
+    {
+        return false;
+    }
+
+    outUpdate = std::move(Updates.front());
+    Updates.pop_front();
+    return true;
 }
 
-DDS_LOADER_RESULT DDSTextureLoaderVk::LoadDDSTextureFromFileEx(
-    VkDevice vkDevice,
-    const char_type* fileName,
-    size_t maxsize,
-    const VkPhysicalDeviceLimits* deviceLimits,
-    VkImageUsageFlags usageFlags,
-    VkImageCreateFlags createFlags,
-    unsigned int loadFlags,
-    VkAllocationCallbacks* allocator,
-    VkImage* texture,
-    std::unique_ptr<uint8_t[]>& ddsData,
-    std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
-    VkImageCreateInfo* outImageCreateInfo,
-    DDS_ALPHA_MODE* outAlphaMode)
+DDS_LOADER_RESULT DDSTextureLoaderVk::TextureFileWatcher::WatchDirectory(const std::basic_string<char_type>& directory)
 {
-    if (texture)
+    WatchedDirectory& watchedDirectory = Directories[directory];
+    if (watchedDirectory.TextureCount++ != 0)
     {
-        *texture = nullptr;
+        return DDS_LOADER_SUCCESS;
     }
-    if (outAlphaMode)
+
+#ifdef __linux__
+    if (NotifyHandle < 0)
     {
-        *outAlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+        NotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
     }
-    if (outImageCreateInfo)
+
+    // Editors either rewrite the file in place or write a temporary file and rename it over the original
+    watchedDirectory.WatchDescriptor = NotifyHandle >= 0
+        ? inotify_add_watch(NotifyHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO)
+        : -1;
+    if (watchedDirectory.WatchDescriptor < 0)
     {
-        memset(outImageCreateInfo, 0, sizeof(VkImageCreateInfo));
+        Directories.erase(directory);
+        return DDS_LOADER_FAIL;
     }
 
-    if (!vkDevice || !fileName || !texture)
+    DirectoriesByWatch[watchedDirectory.WatchDescriptor] = directory;
+#endif
+
+    return DDS_LOADER_SUCCESS;
+}
+
+void DDSTextureLoaderVk::TextureFileWatcher::UnwatchDirectory(const std::basic_string<char_type>& directory)
+{
+    auto watchedDirectory = Directories.find(directory);
+    if (watchedDirectory == Directories.end() || --watchedDirectory->second.TextureCount != 0)
     {
-        return DDS_LOADER_INVALID_ARG;
+        return;
     }
 
-    const DDS_HEADER* header = nullptr;
-    const uint8_t* bitData = nullptr;
-    size_t bitSize = 0;
+#ifdef __linux__
+    inotify_rm_watch(NotifyHandle, watchedDirectory->second.WatchDescriptor);
+    DirectoriesByWatch.erase(watchedDirectory->second.WatchDescriptor);
+#endif
 
-    DDS_LOADER_RESULT errCode = LoadTextureDataFromFile(fileName,
-        ddsData,
-        &header,
-        &bitData,
-        &bitSize
-    );
-    if (errCode != DDS_LOADER_SUCCESS)
+    Directories.erase(watchedDirectory);
+}
+
+void DDSTextureLoaderVk::TextureFileWatcher::Run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The files are reloaded once no events arrived for the coalescing time, editors write them in several steps
+    std::unordered_map<std::basic_string<char_type>, Clock::time_point> pendingFiles;
+
+    const std::chrono::milliseconds coalesceTime(CoalesceMilliseconds);
+    const uint32_t waitMilliseconds = std::min<uint32_t>(std::max<uint32_t>(CoalesceMilliseconds / 2, 10), 100);
+
+#ifndef __linux__
+    Clock::time_point lastScanTime;
+#endif
+
+    while (!IsStopping)
     {
-        return errCode;
+#ifdef __linux__
+        pollfd notifyPoll = {NotifyHandle, POLLIN, 0};
+        if (poll(&notifyPoll, 1, int(waitMilliseconds)) > 0 && (notifyPoll.revents & POLLIN))
+        {
+            alignas(inotify_event) char events[4096];
+            ssize_t readSize = 0;
+            while ((readSize = read(NotifyHandle, events, sizeof(events))) > 0)
+            {
+                const Clock::time_point eventTime = Clock::now();
+
+                std::lock_guard<std::mutex> lock(TexturesMutex);
+                for (ssize_t offset = 0; offset < readSize;)
+                {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(events + offset);
+                    offset += ssize_t(sizeof(inotify_event) + event->len);
+
+                    // The events were lost, check all files
+                    if (event->mask & IN_Q_OVERFLOW)
+                    {
+                        for (const auto& texture : Textures)
+                        {
+                            pendingFiles[texture.second.FilePath] = eventTime;
+                        }
+                        continue;
+                    }
+
+                    auto directory = DirectoriesByWatch.find(event->wd);
+                    if (event->len == 0 || directory == DirectoriesByWatch.end())
+                    {
+                        continue;
+                    }
+
+                    std::basic_string<char_type> filePath = (std::filesystem::path(directory->second) / event->name).string<char_type>();
+                    if (TexturesByPath.count(filePath) != 0)
+                    {
+                        pendingFiles[std::move(filePath)] = eventTime;
+                    }
+                }
+            }
+        }
+#else
+        // No file notifications, compare the last write times on this thread
+        std::this_thread::sleep_for(std::chrono::milliseconds(waitMilliseconds));
+
+        const Clock::time_point scanTime = Clock::now();
+        if (scanTime - lastScanTime >= coalesceTime)
+        {
+            lastScanTime = scanTime;
+
+            std::lock_guard<std::mutex> lock(TexturesMutex);
+            for (auto& texture : Textures)
+            {
+                std::error_code errorCode;
+                const int64_t lastWriteTime = int64_t(std::filesystem::last_write_time(std::filesystem::path(texture.second.FilePath), errorCode).time_since_epoch().count());
+                if (!errorCode && lastWriteTime != texture.second.LastWriteTime)
+                {
+                    texture.second.LastWriteTime = lastWriteTime;
+                    pendingFiles[texture.second.FilePath] = scanTime;
+                }
+            }
+        }
+#endif
+
+        const Clock::time_point now = Clock::now();
+        for (auto pendingFile = pendingFiles.begin(); pendingFile != pendingFiles.end() && !IsStopping;)
+        {
+            if (now - pendingFile->second < coalesceTime)
+            {
+                ++pendingFile;
+                continue;
+            }
+
+            ReloadFile(pendingFile->first);
+            pendingFile = pendingFiles.erase(pendingFile);
+        }
     }
+}
 
-    errCode = CreateTextureFromDDS(vkDevice,
-        header, bitData, bitSize, maxsize,
-        deviceLimits,
-        usageFlags, createFlags, loadFlags,
-        allocator, texture, subresources, outImageCreateInfo);
+void DDSTextureLoaderVk::TextureFileWatcher::ReloadFile(const std::basic_string<char_type>& filePath)
+{
+    // Reload without holding the lock, so that AddTexture and RemoveTexture don't wait for the whole file read
+    std::vector<std::pair<WatchedTextureId, TextureReloadState>> reloads;
+    {
+        std::lock_guard<std::mutex> lock(TexturesMutex);
 
-    if (errCode == DDS_LOADER_SUCCESS)
+        auto paths = TexturesByPath.equal_range(filePath);
+        for (auto path = paths.first; path != paths.second; ++path)
+        {
+            reloads.emplace_back(path->second, Textures.at(path->second).State);
+        }
+    }
+
+    for (auto& reload : reloads)
     {
-        #if defined(WIN32) && defined(DDS_LOADER_PATH_WIDE_CHAR)
-            int filenameSize = WideCharToMultiByte(CP_UTF8, 0, fileName, -1, nullptr, 0, nullptr, nullptr);
+        TextureReloadState& state = reload.second;
 
-            char* filenameU8 = (char*)_malloca(filenameSize + 1);
-            WideCharToMultiByte(CP_UTF8, 0, fileName, -1, filenameU8, filenameSize + 1, nullptr, nullptr);
+        WatchedTextureUpdate update;
+        update.TextureId = reload.first;
 
-            SetDebugTextureInfo(vkDevice, filenameU8, *texture);
-        #else
-            SetDebugTextureInfo(vkDevice, fileName, *texture);
-        #endif // _WIN32
+        // Probe the headers first, so that a broken file is reported without reading all of it
+        alignas(uint32_t) uint8_t headerData[MaxDDSHeaderSize];
+        const DDS_HEADER* header = nullptr;
+        uint64_t bitDataOffset = 0;
+        uint64_t bitSize = 0;
 
-    
-        if (outAlphaMode)
-            *outAlphaMode = GetAlphaMode(header);
-    }
+        update.Result = LoadTextureHeaderFromFile(filePath.c_str(), 0, WholeFileDataSize, headerData, &header, &bitDataOffset, &bitSize);
+        if (update.Result == DDS_LOADER_SUCCESS)
+        {
+            update.Result = ReloadDDSTextureFromFile(Device, filePath.c_str(), MaxSize, HasDeviceLimits ? &DeviceLimits : nullptr,
+                UsageFlags, CreateFlags, LoadFlags, const_cast<VkAllocationCallbacks*>(AllocationCallbacks), state,
+                update.DdsData, update.Subresources, &update.RetiredImage);
+        }
 
-    return errCode;
+        // The file was saved with the same data
+        if (update.Result == DDS_LOADER_SUCCESS && update.Subresources.empty() && update.RetiredImage == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(TexturesMutex);
+
+        auto texture = Textures.find(reload.first);
+        if (texture == Textures.end())
+        {
+            // Removed during the reload, RemoveTexture already returned the previous image. Only the new one is left to destroy
+            if (update.RetiredImage == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+
+            update.Result       = DDS_LOADER_SUCCESS;
+            update.RetiredImage = state.Image;
+            update.Subresources.clear();
+            update.DdsData.reset();
+        }
+        else
+        {
+            texture->second.State = std::move(state);
+
+            update.Image           = texture->second.State.Image;
+            update.ImageCreateInfo = texture->second.State.ImageCreateInfo;
+        }
+
+        std::lock_guard<std::mutex> updatesLock(UpdatesMutex);
+        Updates.push_back(std::move(update));
+    }
 }
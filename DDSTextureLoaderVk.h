@@ -12,9 +12,14 @@
 
 #include <vulkan/vulkan.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -75,6 +80,15 @@ void SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr);
         DDS_LOADER_DEFAULT = 0,
         DDS_LOADER_FORCE_SRGB = 0x1,
         DDS_LOADER_MIP_RESERVE = 0x8,
+        DDS_LOADER_DECOMPRESS_ETC2 = 0x10, //Decompress ETC2 images on CPU, for devices that don't support them
+        DDS_LOADER_DECOMPRESS_ASTC = 0x20, //Decompress LDR ASTC images on CPU, for devices that don't support them
+        DDS_LOADER_COMPRESS_BC = 0x40, //Compress 8-bit RGBA/R/RG images to BC1/BC3/BC4/BC5 on CPU to save video memory
+        DDS_LOADER_DROP_OPAQUE_ALPHA = 0x80, //Detect fully opaque images, transcode them from BC2/BC3 to BC1 and compress them to BC1 with DDS_LOADER_COMPRESS_BC
+        DDS_LOADER_CONVERT_FLOAT = 0x100, //Convert 32-bit float RGB(A) images to R16G16B16A16_SFLOAT, or to B10G11R11_UFLOAT_PACK32 if the values are non-negative and the alpha is unused
+        DDS_LOADER_COLLAPSE_CONSTANT = 0x200, //Create 1x1 single-mip image if every texel of the image is the same
+        DDS_LOADER_FORMAT_LIST = 0x400, //Chain VkImageFormatListCreateInfo for mutable format images created from typeless or FORCE_SRGB data. Requires Vulkan 1.2 or VK_KHR_image_format_list
+        DDS_LOADER_SPARSE_RESIDENCY = 0x800, //Create sparse resident image (VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT). Use GetSparseSubresourceLayout() to split the subresources into tiles
+        DDS_LOADER_DEFER_CREATION = 0x1000, //Don't create the image, only return its create info and the subresources. vkDevice and texture may be null, outImageCreateInfo is required
     };
 
     enum DDS_LOADER_RESULT: uint32_t
@@ -101,10 +115,67 @@ void SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr);
     {
         const uint8_t*     PData;            //Pointer to the subresource data
         size_t             DataByteSize;     //The size of the subresource data, in bytes
-        VkImageSubresource SubresourceSlice; //The slice (mip level, array layer, and possibly plane) of the subresource
+        VkImageSubresource SubresourceSlice; //The slice (mip level, array layer, and possibly plane) of the subresource in the created image, without the skipped file mips and layers
         VkExtent3D         Extent;           //The extent (width-height-depth) of the subresource
     };
 
+#ifdef VK_KHR_image_format_list
+    //Helper struct to describe the view formats of a mutable format image
+    struct ImageFormatList
+    {
+        VkImageFormatListCreateInfoKHR CreateInfo;     //Chained to VkImageCreateInfo, points to ViewFormats
+        VkFormat                       ViewFormats[8]; //The formats the image can be viewed as
+    };
+#endif
+
+    //Helper struct to own the data produced by the loader itself (i.e. decompressed subresources)
+    //The returned subresources and the returned VkImageCreateInfo may point into it, so it must outlive them
+    struct LoadedTextureStorage
+    {
+        std::unique_ptr<uint8_t[]> PData;            //The data produced by the loader, if any
+        size_t                     DataByteSize = 0; //The size of the data in PData, in bytes
+
+#ifdef VK_KHR_image_format_list
+        std::unique_ptr<ImageFormatList> FormatList; //The view format list the image was created with, if any
+#endif
+    };
+
+    //Helper struct to limit the memory taken by the loaded images. Share it between several loads to budget a whole batch
+    //The loader drops the top mips of the images that don't fit into the remaining budget
+    struct LoadMemoryBudget
+    {
+        size_t BudgetByteSize = 0; //The total size of image data the loads may take, in bytes
+        size_t UsedByteSize   = 0; //The size of image data already taken, in bytes. Every successful load adds the size of its subresources
+    };
+
+    //Helper struct to drop the top mips one by one when the device runs out of memory creating the image
+    struct MipDropPolicy
+    {
+        uint32_t MinMipCount     = 1; //The image is never dropped below this many mips
+        uint32_t SkippedMipCount = 0; //Returned by the loader: the number of top mips of the file that were not loaded
+    };
+
+    //Helper struct to share the images of byte-identical DDS data between the loads of a batch or a session.
+    //A load of the data already loaded with the same parameters returns the cached image and no subresources to upload.
+    //The application owns the images: destroy every image of Textures once. Not thread-safe, same as LoadMemoryBudget.
+    //Can't be combined with LoadMemoryBudget or MipDropPolicy, they make the image depend on more than the load parameters
+    struct TextureDedupCache
+    {
+        struct CachedTexture
+        {
+            VkImage           Image           = VK_NULL_HANDLE;
+            VkImageCreateInfo ImageCreateInfo = {};                     //The create info of the image, without pNext
+            DDS_ALPHA_MODE    AlphaMode       = DDS_ALPHA_MODE_UNKNOWN;
+            uint32_t          SkippedMipCount = 0;
+            size_t            DataByteSize    = 0;                      //The size of the subresources uploaded to the image, in bytes
+        };
+
+        std::unordered_map<uint64_t, CachedTexture> Textures;        //By the XXH64 hash of the headers, the loaded data and the load parameters
+        size_t                                      HitCount    = 0; //The loads that returned a cached image
+        size_t                                      MissCount   = 0; //The loads that created a new image
+        size_t                                      HitByteSize = 0; //The size of the subresource data the hits didn't upload, in bytes
+    };
+
     // Standard version
     DDS_LOADER_RESULT __cdecl LoadDDSTextureFromMemory(
         VkDevice vkDevice,
@@ -140,7 +211,12 @@ void SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr);
         VkImage* texture,
         std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
         VkImageCreateInfo* outImageCreateInfo = nullptr,
-        DDS_ALPHA_MODE* alphaMode = nullptr);
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr,
+        DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget = nullptr,
+        DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy = nullptr,
+        const VkImageSubresourceRange* subresourceRange = nullptr, //The file mip levels and array layers to load, nullptr loads all. The returned subresources are counted from the first loaded ones
+        DDSTextureLoaderVk::TextureDedupCache* dedupCache = nullptr);
 
     DDS_LOADER_RESULT __cdecl LoadDDSTextureFromFileEx(
         VkDevice vkDevice,
@@ -155,5 +231,576 @@ void SetVkSetDebugUtilsObjectNameUserPtr(void* userPtr);
         std::unique_ptr<uint8_t[]>& ddsData,
         std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
         VkImageCreateInfo* outImageCreateInfo = nullptr,
-        DDS_ALPHA_MODE* alphaMode = nullptr);
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr,
+        DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget = nullptr,
+        DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy = nullptr,
+        const VkImageSubresourceRange* subresourceRange = nullptr, //The file mip levels and array layers to load, nullptr loads all. The returned subresources are counted from the first loaded ones
+        DDSTextureLoaderVk::TextureDedupCache* dedupCache = nullptr);
+
+    // Version for the DDS data of ddsDataSize bytes embedded at fileOffset in a larger file.
+    // ddsDataSize of UINT64_MAX means the data reaches the end of the file
+    DDS_LOADER_RESULT __cdecl LoadDDSTextureFromFileRange(
+        VkDevice vkDevice,
+        const char_type* fileName,
+        uint64_t fileOffset,
+        uint64_t ddsDataSize,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        VkImage* texture,
+        std::unique_ptr<uint8_t[]>& ddsData,
+        std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+        VkImageCreateInfo* outImageCreateInfo = nullptr,
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr,
+        DDSTextureLoaderVk::LoadMemoryBudget* memoryBudget = nullptr,
+        DDSTextureLoaderVk::MipDropPolicy* mipDropPolicy = nullptr,
+        const VkImageSubresourceRange* subresourceRange = nullptr, //The file mip levels and array layers to load, nullptr loads all. The returned subresources are counted from the first loaded ones
+        DDSTextureLoaderVk::TextureDedupCache* dedupCache = nullptr);
+
+    //Loads 2D textures of the same format, extent and mip count from fileCount files into a single array image, with the files read in parallel.
+    //The layers of the files follow each other in the order of fileNames. The subresources point into ddsData (one entry per file),
+    //their mip levels and array layers are the image ones. outFailedFileIndex returns the file that failed to load or didn't match the first one
+    DDS_LOADER_RESULT __cdecl LoadDDSTextureArrayFromFiles(
+        VkDevice vkDevice,
+        const char_type* const* fileNames,
+        size_t fileCount,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        VkImage* texture,
+        std::vector<std::unique_ptr<uint8_t[]>>& ddsData,
+        std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+        VkImageCreateInfo* outImageCreateInfo = nullptr,
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr,
+        size_t* outFailedFileIndex = nullptr);
+
+    //Helper struct to describe where a texture is placed in a TextureAtlas
+    struct AtlasTexturePlacement
+    {
+        uint32_t       AtlasIndex = 0;                     //The index of the atlas
+        VkOffset3D     Offset     = {};                    //The offset of the texture in mip level 0 of the atlas, in texels
+        VkExtent3D     Extent     = {};                    //The extent of the texture, in texels
+        float          UvOffset[2] = {};                   //The texture coordinates of the texture corner in the atlas
+        float          UvScale[2]  = {};                   //The scale from the texture coordinates of the texture to the atlas ones
+        DDS_ALPHA_MODE AlphaMode   = DDS_ALPHA_MODE_UNKNOWN;
+    };
+
+    //Helper struct to describe an atlas image created by LoadDDSTextureAtlasFromFiles().
+    //Copy the data of every subresource to a staging buffer of StagingByteSize bytes at the bufferOffset of its copy region,
+    //then copy all regions to Image with a single vkCmdCopyBufferToImage
+    struct TextureAtlas
+    {
+        VkImage                            Image           = VK_NULL_HANDLE;
+        VkImageCreateInfo                  ImageCreateInfo = {};
+        std::vector<LoadedSubresourceData> Subresources;        //The subresources of the packed textures, they point into ddsData
+        std::vector<VkBufferImageCopy>     CopyRegions;         //The copy region of every subresource
+        VkDeviceSize                       StagingByteSize = 0;
+        LoadedTextureStorage               Storage;             //Keeps the view format list of ImageCreateInfo
+    };
+
+    //Packs small 2D textures from fileCount files into a few atlas images of up to atlasSize x atlasSize texels, with the files read in parallel.
+    //The textures are grouped by format, every group is packed into its own atlases. paddingTexels of empty space is kept between the textures at every mip level.
+    //outPlacements returns the placement of every file. outFailedFileIndex returns the file that failed to load or couldn't be packed
+    DDS_LOADER_RESULT __cdecl LoadDDSTextureAtlasFromFiles(
+        VkDevice vkDevice,
+        const char_type* const* fileNames,
+        size_t fileCount,
+        uint32_t atlasSize,
+        uint32_t paddingTexels,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        std::vector<std::unique_ptr<uint8_t[]>>& ddsData,
+        std::vector<DDSTextureLoaderVk::AtlasTexturePlacement>& outPlacements,
+        std::vector<DDSTextureLoaderVk::TextureAtlas>& outAtlases,
+        size_t* outFailedFileIndex = nullptr);
+
+    //Callback invoked by LoadDDSTextureFromFileProgressive() for the loaded mip levels, from the smallest to the largest one.
+    //The subresource data is only valid during the call. Return false to stop loading the remaining mip levels
+    typedef bool (*PFN_DdsLoader_MipLoadedCallback)(void* userData, const DDSTextureLoaderVk::LoadedSubresourceData* subresources, size_t subresourceCount);
+
+    // Progressive version. If reading the file fails after the image has been created, the error is returned
+    // together with the image in texture, which the application has to destroy
+    DDS_LOADER_RESULT __cdecl LoadDDSTextureFromFileProgressive(
+        VkDevice vkDevice,
+        const char_type* fileName,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        VkImage* texture,
+        DDSTextureLoaderVk::PFN_DdsLoader_MipLoadedCallback mipLoadedCallback,
+        void* callbackUserData,
+        bool callbackPerSubresource = false,
+        VkImageCreateInfo* outImageCreateInfo = nullptr,
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr);
+
+    //Callback invoked by LoadDDSTextureFromReader() to read size bytes at offset from the start of the DDS data into dst.
+    //Return false if the read fails
+    typedef bool (*PFN_DdsLoader_ReadCallback)(void* userData, uint64_t offset, size_t size, void* dst);
+
+    //Callback invoked by LoadDDSTextureFromReader() for every subresource before its data is read, in the data order.
+    //Returns the destination for at least DataByteSize bytes of the subresource data (i.e. mapped staging memory), the PData of the subresource is null.
+    //The previous destination has been filled when the callback is invoked again. Return nullptr to stop loading the remaining subresources
+    typedef void* (*PFN_DdsLoader_SubresourceDestinationCallback)(void* userData, const DDSTextureLoaderVk::LoadedSubresourceData* subresource);
+
+    // Streaming version. If a read fails after the image has been created, the error is returned
+    // together with the image in texture, which the application has to destroy
+    DDS_LOADER_RESULT __cdecl LoadDDSTextureFromReader(
+        VkDevice vkDevice,
+        DDSTextureLoaderVk::PFN_DdsLoader_ReadCallback readCallback,
+        void* readUserData,
+        uint64_t ddsDataSize,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        VkImage* texture,
+        DDSTextureLoaderVk::PFN_DdsLoader_SubresourceDestinationCallback destinationCallback,
+        void* destinationUserData,
+        VkImageCreateInfo* outImageCreateInfo = nullptr,
+        DDS_ALPHA_MODE* alphaMode = nullptr,
+        DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr);
+
+    //Helper struct to keep the state of a texture between the ReloadDDSTextureFromFile() calls. Start with an empty state
+    struct TextureReloadState
+    {
+        VkImage               Image           = VK_NULL_HANDLE; //The current image of the texture
+        VkImageCreateInfo     ImageCreateInfo = {};             //The create info of Image, without pNext
+        uint64_t              HeaderHash      = 0;              //The XXH64 hash of the headers and the load parameters
+        std::vector<uint64_t> SubresourceHashes;                //The XXH64 hashes of the subresources of Image, in the data order
+    };
+
+    //Reloads the texture after its file changed and returns only the subresources whose data differs from the previous load.
+    //state.Image is reused if the headers and the load parameters didn't change, otherwise a new image is created, all of its
+    //subresources are returned and the previous image is returned in outRetiredImage, for the application to destroy.
+    //outRetiredImage can only be omitted while state.Image is VK_NULL_HANDLE
+    DDS_LOADER_RESULT __cdecl ReloadDDSTextureFromFile(
+        VkDevice vkDevice,
+        const char_type* fileName,
+        size_t maxsize,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkImageUsageFlags usageFlags,
+        VkImageCreateFlags createFlags,
+        unsigned int loadFlags,
+        VkAllocationCallbacks* allocationCallbacks,
+        DDSTextureLoaderVk::TextureReloadState& state,
+        std::unique_ptr<uint8_t[]>& ddsData,
+        std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& changedSubresources,
+        VkImage* outRetiredImage = nullptr);
+
+    typedef uint32_t WatchedTextureId;
+
+    //Helper struct to describe a texture loaded or reloaded by TextureFileWatcher
+    struct WatchedTextureUpdate
+    {
+        WatchedTextureId                   TextureId       = 0;
+        DDS_LOADER_RESULT                  Result          = DDS_LOADER_SUCCESS; //The result of the reload. The texture keeps its image if it failed
+        VkImage                            Image           = VK_NULL_HANDLE;     //The current image of the texture
+        VkImageCreateInfo                  ImageCreateInfo = {};                 //The create info of Image, without pNext
+        VkImage                            RetiredImage    = VK_NULL_HANDLE;     //The previous image to destroy once it's not in use, if the image was recreated
+        std::vector<LoadedSubresourceData> Subresources;                         //The subresources to upload to Image, they point into DdsData
+        std::unique_ptr<uint8_t[]>         DdsData;                              //The file contents
+    };
+
+    //Watches the files of the added textures and reloads the changed ones with ReloadDDSTextureFromFile() on a background thread.
+    //Uses inotify on Linux, the other platforms compare the last write times on the background thread.
+    //The events of a file are coalesced: it's reloaded once no events arrived for coalesceMilliseconds.
+    //The reloads are delivered through PopUpdate(). All functions may be called from any thread.
+    //The watcher never destroys images, see WatchedTextureUpdate and RemoveTexture(). Before destroying the watcher,
+    //remove every texture still registered, call Stop() and drain the remaining updates with PopUpdate()
+    class TextureFileWatcher
+    {
+    public:
+        TextureFileWatcher(VkDevice vkDevice,
+            size_t maxsize,
+            const VkPhysicalDeviceLimits* deviceLimits,
+            VkImageUsageFlags usageFlags,
+            VkImageCreateFlags createFlags,
+            unsigned int loadFlags,
+            const VkAllocationCallbacks* allocationCallbacks = nullptr,
+            uint32_t coalesceMilliseconds = 200);
+        ~TextureFileWatcher();
+
+        TextureFileWatcher(const TextureFileWatcher&)            = delete;
+        TextureFileWatcher& operator=(const TextureFileWatcher&) = delete;
+
+        //Loads the texture and starts watching its file. outUpdate returns the initial load
+        DDS_LOADER_RESULT AddTexture(const char_type* fileName,
+            WatchedTextureId* outTextureId,
+            WatchedTextureUpdate& outUpdate);
+
+        //Stops watching the texture. Returns the image the application has to destroy
+        VkImage RemoveTexture(WatchedTextureId textureId);
+
+        //Pops the oldest completed reload. Returns false if there is none. Keeps working after Stop()
+        bool PopUpdate(WatchedTextureUpdate& outUpdate);
+
+        //Waits for the reload in flight and stops watching. AddTexture() fails afterwards. Called by the destructor
+        void Stop();
+
+    private:
+        struct WatchedTexture
+        {
+            std::basic_string<char_type> FilePath;          //The absolute path
+            TextureReloadState           State;
+            int64_t                      LastWriteTime = 0; //Only used without inotify
+        };
+
+        struct WatchedDirectory
+        {
+            int      WatchDescriptor = -1;
+            uint32_t TextureCount    = 0;
+        };
+
+        DDS_LOADER_RESULT WatchDirectory(const std::basic_string<char_type>& directory);
+        void              UnwatchDirectory(const std::basic_string<char_type>& directory);
+        void              Run();
+        void              ReloadFile(const std::basic_string<char_type>& filePath);
+
+        VkDevice                     Device;
+        size_t                       MaxSize;
+        VkPhysicalDeviceLimits       DeviceLimits;
+        bool                         HasDeviceLimits;
+        VkImageUsageFlags            UsageFlags;
+        VkImageCreateFlags           CreateFlags;
+        unsigned int                 LoadFlags;
+        const VkAllocationCallbacks* AllocationCallbacks;
+        uint32_t                     CoalesceMilliseconds;
+
+        std::mutex                                                              TexturesMutex;
+        std::unordered_map<WatchedTextureId, WatchedTexture>                    Textures;
+        std::unordered_multimap<std::basic_string<char_type>, WatchedTextureId> TexturesByPath;
+        std::unordered_map<std::basic_string<char_type>, WatchedDirectory>      Directories;
+        std::unordered_map<int, std::basic_string<char_type>>                   DirectoriesByWatch;
+        WatchedTextureId                                                        NextTextureId;
+
+        std::mutex                       UpdatesMutex;
+        std::deque<WatchedTextureUpdate> Updates;
+
+        int               NotifyHandle; //The inotify instance on Linux
+        std::atomic<bool> IsStopping;
+        std::thread       WatchThread;
+    };
+
+#ifdef VK_KHR_maintenance4
+    //Helper struct to describe where an image is placed in the memory blocks of ImageMemoryPlan
+    struct PlannedImageMemory
+    {
+        VkMemoryRequirements MemoryRequirements = {}; //The requirements returned by vkGetDeviceImageMemoryRequirements
+        uint32_t             BlockIndex         = 0;  //The index of the block in ImageMemoryPlan::Blocks
+        VkDeviceSize         Offset             = 0;  //The offset of the image in the block, for vkBindImageMemory
+    };
+
+    //Helper struct to describe a memory block to allocate with vkAllocateMemory
+    struct PlannedMemoryBlock
+    {
+        uint32_t     MemoryTypeIndex = 0;
+        VkDeviceSize ByteSize        = 0;
+        bool         IsDedicated     = false; //The block holds a single image that prefers or requires a dedicated allocation (VkMemoryDedicatedAllocateInfo)
+    };
+
+    //Helper struct to describe the memory of a batch of images
+    struct ImageMemoryPlan
+    {
+        std::vector<PlannedImageMemory> Images; //In the order of the image create infos
+        std::vector<PlannedMemoryBlock> Blocks;
+    };
+
+    //Queries the memory requirements of the images from their create infos (i.e. returned with DDS_LOADER_DEFER_CREATION), before the images exist,
+    //and suballocates them from as few memory blocks as possible. getDeviceImageMemoryRequirements is vkGetDeviceImageMemoryRequirements (Vulkan 1.3)
+    //or vkGetDeviceImageMemoryRequirementsKHR (VK_KHR_maintenance4).
+    //blockByteSize limits the size of the blocks, 0 means unlimited. Images that don't fit into a block get a block of their own
+    DDS_LOADER_RESULT __cdecl PlanImageMemory(
+        VkDevice vkDevice,
+        PFN_vkGetDeviceImageMemoryRequirementsKHR getDeviceImageMemoryRequirements,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties,
+        const VkPhysicalDeviceLimits* deviceLimits,
+        VkMemoryPropertyFlags memoryPropertyFlags,
+        VkDeviceSize blockByteSize,
+        const VkImageCreateInfo* imageCreateInfos,
+        size_t imageCount,
+        DDSTextureLoaderVk::ImageMemoryPlan& outPlan);
+#endif
+
+    //Helper struct to describe a sparse image tile of a loaded subresource
+    struct LoadedSparseTile
+    {
+        const uint8_t*     PData;            //Pointer to the first texel block of the tile in the subresource data
+        uint32_t           RowLength;        //The row length of the subresource data, in texels (VkBufferImageCopy::bufferRowLength)
+        uint32_t           ImageHeight;      //The height of the subresource data, in texels (VkBufferImageCopy::bufferImageHeight)
+        VkImageSubresource SubresourceSlice; //The image subresource of the tile, the mip level and the array layer are the image ones
+        VkOffset3D         Offset;           //The offset of the tile in the subresource, in texels
+        VkExtent3D         Extent;           //The extent of the tile, in texels. Clamped to the subresource extent
+    };
+
+    //Helper struct to describe the loaded subresources of a sparse resident image
+    struct LoadedSparseLayout
+    {
+        std::vector<LoadedSparseTile>      Tiles;           //The tiles of the mip levels before the mip tail
+        uint32_t                           MipTailFirstLod; //The first image mip level in the mip tail. Equals the mip count if there's no mip tail
+        std::vector<LoadedSubresourceData> MipTail;         //The subresources in the mip tail, which is bound as a whole. The mip levels and array layers are the image ones
+    };
+
+    //Splits the loaded subresources of the image into sparse tiles and the mip tail according to formatProperties.
+    //Doesn't need a device, so the layout can be computed for any sparse properties
+    DDS_LOADER_RESULT __cdecl GetSparseSubresourceLayout(
+        VkFormat format,
+        const VkSparseImageFormatProperties& formatProperties,
+        const std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+        DDSTextureLoaderVk::LoadedSparseLayout& outLayout);
+
+    //Identifier of a texture tracked by MipResidencyManager. 0 is never a valid identifier
+    typedef uint32_t ResidentTextureId;
+
+    //Helper struct to describe the image recreated by MipResidencyManager with a new resident mip range. The application has to:
+    //1. Bind memory to NewImage;
+    //2. Copy CopyRegions from OldImage to NewImage and upload Subresources to NewImage;
+    //3. Destroy OldImage once the copies are done.
+    struct ResidencyUpdate
+    {
+        ResidentTextureId                  TextureId          = 0;
+        VkImage                            OldImage           = VK_NULL_HANDLE; //The previous image of the texture, VK_NULL_HANDLE if the texture has just been added
+        VkImage                            NewImage           = VK_NULL_HANDLE; //The image with the new resident mip range
+        VkImageCreateInfo                  NewImageCreateInfo = {};             //The create info NewImage was created with
+        uint32_t                           FirstResidentMip   = 0;              //The file mip level that is mip level 0 of NewImage
+        std::vector<VkImageCopy>           CopyRegions;                         //The mip levels to copy from OldImage to NewImage
+        std::vector<LoadedSubresourceData> Subresources;                        //The mip levels read from the file. The mip levels are the ones of NewImage
+        LoadedTextureStorage               Storage;                             //The storage Subresources and NewImageCreateInfo point into
+    };
+
+    //Tracks the resident mip range of the textures and recreates them to fit into the memory budget.
+    //Textures are downgraded to fewer top mips under memory pressure, least important and least recently used ones first,
+    //and upgraded to the mips requested by the renderer by reading only the missing mip levels from the file.
+    //The manager never destroys images and never records commands, see ResidencyUpdate.
+    //ReportUsage() may be called from any thread, the rest of the functions must be called from a single thread.
+    class MipResidencyManager
+    {
+    public:
+        MipResidencyManager(VkDevice vkDevice,
+            size_t budgetByteSize,
+            const VkPhysicalDeviceLimits* deviceLimits,
+            VkImageUsageFlags usageFlags,
+            VkImageCreateFlags createFlags,
+            unsigned int loadFlags,
+            const VkAllocationCallbacks* allocationCallbacks = nullptr);
+
+        //Starts tracking the texture and creates it with the minResidentMips smallest mip levels. These levels are never evicted
+        DDS_LOADER_RESULT AddTexture(const char_type* fileName,
+            uint32_t minResidentMips,
+            uint32_t priority,
+            ResidentTextureId* outTextureId,
+            ResidencyUpdate& outUpdate);
+
+        //Stops tracking the texture. Returns the image the application has to destroy
+        VkImage RemoveTexture(ResidentTextureId textureId);
+
+        //Reports that the texture was used in the frame with finestMip being the most detailed file mip level needed
+        void ReportUsage(ResidentTextureId textureId, uint64_t frameIndex, uint32_t finestMip, uint32_t priority);
+
+        //Applies the reported usage and recreates the textures whose resident mip range changed.
+        //At most maxUpgradeCount textures are upgraded per call, the downgrades needed to free the memory for them are always made
+        DDS_LOADER_RESULT Update(std::vector<ResidencyUpdate>& outUpdates, size_t maxUpgradeCount);
+
+        void   SetBudgetByteSize(size_t budgetByteSize);
+        size_t GetBudgetByteSize() const;
+        size_t GetUsedByteSize() const;
+
+        VkImage  GetImage(ResidentTextureId textureId) const;
+        uint32_t GetFirstResidentMip(ResidentTextureId textureId) const;
+
+    private:
+        struct ResidentTexture
+        {
+            std::basic_string<char_type> FileName;
+            uint64_t                     BitDataOffset     = 0; //The offset of the first subresource in the file
+            std::vector<size_t>          MipByteSizes;          //The sizes of the mip levels of a single array layer
+            size_t                       LayerByteSize     = 0; //The size of all mip levels of a single array layer
+            VkImageType                  ImageType         = VK_IMAGE_TYPE_2D;
+            VkFormat                     Format            = VK_FORMAT_UNDEFINED;
+            VkExtent3D                   Extent            = {};
+            uint32_t                     MipCount          = 1;
+            uint32_t                     ArraySize         = 1;
+            VkImageCreateFlags           CreateFlags       = 0;
+            bool                         IsTypeless        = false;
+            uint32_t                     MinResidentMips   = 1;
+            VkImage                      Image             = VK_NULL_HANDLE;
+            uint32_t                     FirstResidentMip  = 0;
+            uint32_t                     RequestedFirstMip = 0;
+            uint32_t                     Priority          = 0;
+            uint64_t                     LastUsedFrame     = 0;
+        };
+
+        struct TextureUsage
+        {
+            ResidentTextureId TextureId;
+            uint64_t          FrameIndex;
+            uint32_t          FinestMip;
+            uint32_t          Priority;
+        };
+
+        size_t GetResidentByteSize(const ResidentTexture& texture, uint32_t firstMip) const;
+        DDS_LOADER_RESULT Recreate(ResidentTextureId textureId, ResidentTexture& texture, uint32_t firstMip, ResidencyUpdate& outUpdate);
+
+        VkDevice                     Device;
+        size_t                       BudgetByteSize;
+        size_t                       UsedByteSize;
+        VkPhysicalDeviceLimits       DeviceLimits;
+        bool                         HasDeviceLimits;
+        VkImageUsageFlags            UsageFlags;
+        VkImageCreateFlags           CreateFlags;
+        unsigned int                 LoadFlags;
+        const VkAllocationCallbacks* AllocationCallbacks;
+
+        std::unordered_map<ResidentTextureId, ResidentTexture> Textures;
+        ResidentTextureId                                      NextTextureId;
+
+        std::mutex                UsageMutex;
+        std::vector<TextureUsage> PendingUsage;
+    };
+
+    //Helper struct to describe a texture written into a texture pack by WriteTexturePack()
+    struct TexturePackEntry
+    {
+        const char*      Name;     //The name the texture is looked up by, unique in the pack
+        const char_type* FileName; //The DDS file of the texture
+    };
+
+    //Writes the DDS files into a single texture pack archive. Every subresource payload is aligned to copyOffsetAlignment
+    //(i.e. optimalBufferCopyOffsetAlignment) and to the texel block size.
+    //compressPayloads stores every subresource as a separate LZ4 block, the ones that don't get smaller are stored as is
+    DDS_LOADER_RESULT __cdecl WriteTexturePack(
+        const char_type* packFileName,
+        const DDSTextureLoaderVk::TexturePackEntry* entries,
+        size_t entryCount,
+        VkDeviceSize copyOffsetAlignment,
+        bool compressPayloads = false);
+
+    //Helper class to load textures from a memory-mapped texture pack archive
+    class TexturePackReader
+    {
+    public:
+        TexturePackReader() = default;
+        ~TexturePackReader();
+
+        TexturePackReader(const TexturePackReader&)            = delete;
+        TexturePackReader& operator=(const TexturePackReader&) = delete;
+
+        //Maps the archive and validates its tables
+        DDS_LOADER_RESULT Open(const char_type* packFileName);
+        void              Close();
+
+        uint32_t          GetTextureCount() const;
+        const char*       GetTextureName(uint32_t textureIndex) const;
+        DDS_LOADER_RESULT FindTexture(const char* name, uint32_t* outTextureIndex) const;
+
+        //The payloads of all subresources of the texture, the copy regions of LoadTexture() are relative to it.
+        //outData is nullptr for compressed textures, read them with ReadTexturePayload()
+        DDS_LOADER_RESULT GetTexturePayload(uint32_t textureIndex, const uint8_t** outData, size_t* outByteSize) const;
+
+        //Decompresses (or copies) the subresources of the copy regions to their bufferOffset in dstPayload, in parallel.
+        //dstPayload is the staging memory of GetTexturePayload() outByteSize bytes
+        DDS_LOADER_RESULT ReadTexturePayload(uint32_t textureIndex,
+            const VkBufferImageCopy* copyRegions,
+            size_t copyRegionCount,
+            void* dstPayload) const;
+
+        //Creates the image. The subresources point into the mapped archive until Close(), the mip levels are the image ones.
+        //The compressed subresources are decompressed into outStorage. Without it their PData is nullptr and outCopyRegions is required
+        DDS_LOADER_RESULT LoadTexture(uint32_t textureIndex,
+            VkDevice vkDevice,
+            size_t maxsize,
+            const VkPhysicalDeviceLimits* deviceLimits,
+            VkImageUsageFlags usageFlags,
+            VkImageCreateFlags createFlags,
+            unsigned int loadFlags,
+            VkAllocationCallbacks* allocationCallbacks,
+            VkImage* texture,
+            std::vector<DDSTextureLoaderVk::LoadedSubresourceData>& subresources,
+            std::vector<VkBufferImageCopy>* outCopyRegions = nullptr,
+            VkImageCreateInfo* outImageCreateInfo = nullptr,
+            DDS_ALPHA_MODE* alphaMode = nullptr,
+            DDSTextureLoaderVk::LoadedTextureStorage* outStorage = nullptr) const;
+
+    private:
+        const uint8_t* MappedData     = nullptr;
+        size_t         MappedByteSize = 0;
+        void*          MappingHandle  = nullptr; //The file mapping object on Windows
+    };
+
+    //Helper struct to describe a subresource of an indexed DDS file
+    struct IndexedSubresource
+    {
+        VkImageSubresource SubresourceSlice; //The slice of the subresource, with the file mip level
+        VkExtent3D         Extent;           //The extent (width-height-depth) of the subresource
+        uint64_t           FileOffset;       //The offset of the subresource data in the file
+        uint64_t           DataByteSize;     //The size of the subresource data, in bytes
+    };
+
+    //Helper struct to describe a DDS file recorded in a texture index
+    struct IndexedTexture
+    {
+        const char*               FileName;         //The UTF-8 file name, relative to the indexed directory
+        uint64_t                  FileSize;         //The file size when the headers were parsed
+        int64_t                   LastWriteTime;    //The std::filesystem::last_write_time() ticks when the headers were parsed
+        VkImageType               ImageType;
+        VkFormat                  Format;
+        VkExtent3D                Extent;
+        uint32_t                  MipLevels;
+        uint32_t                  ArrayLayers;
+        VkImageCreateFlags        CreateFlags;      //The flags the image requires (cube, 2D array compatible or mutable format)
+        DDS_ALPHA_MODE            AlphaMode;
+        const IndexedSubresource* Subresources;     //All subresources in the data order, points into the mapped index
+        uint32_t                  SubresourceCount;
+    };
+
+    //Creates or updates the header index of the DDS files in the directory. Only the new and modified files (by size and
+    //last write time) are parsed, the files that fail to parse are left out. The index is not rewritten if nothing changed.
+    //Close the TextureIndexReader of the index before updating it
+    DDS_LOADER_RESULT __cdecl UpdateTextureIndex(
+        const char_type* directory,
+        const char_type* indexFileName,
+        size_t* outParsedCount = nullptr);
+
+    //Helper class to look up the parsed headers of DDS files in a memory-mapped texture index
+    class TextureIndexReader
+    {
+    public:
+        TextureIndexReader() = default;
+        ~TextureIndexReader();
+
+        TextureIndexReader(const TextureIndexReader&)            = delete;
+        TextureIndexReader& operator=(const TextureIndexReader&) = delete;
+
+        //Maps the index and validates its tables
+        DDS_LOADER_RESULT Open(const char_type* indexFileName);
+        void              Close();
+
+        uint32_t          GetTextureCount() const;
+        DDS_LOADER_RESULT FindTexture(const char* fileName, uint32_t* outTextureIndex) const;
+
+        //The returned texture points into the mapped index until Close()
+        DDS_LOADER_RESULT GetTexture(uint32_t textureIndex, DDSTextureLoaderVk::IndexedTexture* outTexture) const;
+
+    private:
+        const uint8_t* MappedData     = nullptr;
+        size_t         MappedByteSize = 0;
+        void*          MappingHandle  = nullptr; //The file mapping object on Windows
+    };
 }
\ No newline at end of file